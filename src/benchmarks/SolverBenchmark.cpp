@@ -0,0 +1,132 @@
+// Thread scaling of the classic and pipelined conjugate gradient on a synthetic elastic system.
+// Usage: solver-benchmark [grid size = 40] [solves per measure = 5] [max threads = number of processors]
+
+#include <omp.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "sim/IFEM.hpp"
+#include "sim/BlockSparseMatrix.hpp"
+#include "sim/solvers/ConjugateGradient.hpp"
+#include "utils/Timer.hpp"
+
+using sim::Float;
+using sim::Vec;
+using sim::Vec3;
+using sim::Mat3;
+
+namespace {
+
+// System M + K of a grid of n^3 nodes, where every pair of neighbours in the 27 point stencil
+// is joined by a spring with stiffness k * (I + d * d^T), for the unit direction d between them.
+// It has the pattern of a hexahedral mesh split in tetrahedra, and is symmetric positive definite.
+void build_system(uint32_t n, Float mass, Float k, sim::BlockSparseMatrix* A)
+{
+	const uint32_t num_nodes = n * n * n;
+	auto node = [n](int32_t x, int32_t y, int32_t z) { return (uint32_t)(x + (int32_t)n * (y + (int32_t)n * z)); };
+	auto inside = [n](int32_t c) { return c >= 0 && c < (int32_t)n; };
+
+	std::vector<std::vector<uint32_t>> row_columns(num_nodes);
+	for (int32_t z = 0; z < (int32_t)n; ++z) {
+		for (int32_t y = 0; y < (int32_t)n; ++y) {
+			for (int32_t x = 0; x < (int32_t)n; ++x) {
+				std::vector<uint32_t>& columns = row_columns[node(x, y, z)];
+				for (int32_t dz = -1; dz <= 1; ++dz) {
+					for (int32_t dy = -1; dy <= 1; ++dy) {
+						for (int32_t dx = -1; dx <= 1; ++dx) {
+							if (inside(x + dx) && inside(y + dy) && inside(z + dz) &&
+								node(x + dx, y + dy, z + dz) >= node(x, y, z)) {
+								columns.push_back(node(x + dx, y + dy, z + dz));
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	A->set_pattern(row_columns, true);
+	A->set_zero();
+
+	for (uint32_t i = 0; i < num_nodes; ++i) {
+		A->diagonal_block(i) += mass * Mat3::Identity();
+		const Vec3 p_i((Float)(i % n), (Float)(i / n % n), (Float)(i / (n * n)));
+		for (uint32_t b = A->diagonal_index(i) + 1; b < A->row_end(i); ++b) {
+			const uint32_t j = A->block_column(b);
+			const Vec3 p_j((Float)(j % n), (Float)(j / n % n), (Float)(j / (n * n)));
+			const Vec3 d = (p_j - p_i).normalized();
+			const Mat3 K = k * (Mat3::Identity() + d * d.transpose());
+			A->block(b) = -K;
+			A->diagonal_block(i) += K;
+			A->diagonal_block(j) += K;
+		}
+	}
+}
+
+struct Measure {
+	double ms_per_solve = 0.0;
+	uint32_t iterations = 0;
+};
+
+Measure measure(const sim::BlockSparseMatrix& A, const Vec& b, sim::ConjugateGradientVariant variant,
+	uint32_t num_solves)
+{
+	sim::ConjugateGradient cg((size_t)b.rows());
+	cg.set_preconditioner(sim::Preconditioner::BlockJacobi);
+	cg.set_initial_guess(sim::InitialGuess::Zero);
+	cg.set_variant(variant);
+
+	// The first solve allocates the vectors
+	Vec x = Vec::Zero(b.rows());
+	cg.solve(A, b, &x);
+
+	Timer timer;
+	for (uint32_t s = 0; s < num_solves; ++s) {
+		cg.solve(A, b, &x);
+	}
+
+	Measure result;
+	result.ms_per_solve = timer.getDuration<Timer::Millis>().count() / num_solves;
+	result.iterations = cg.iterations();
+	return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	const uint32_t grid_size = argc > 1 ? (uint32_t)std::atoi(argv[1]) : 40;
+	const uint32_t num_solves = argc > 2 ? (uint32_t)std::atoi(argv[2]) : 5;
+	const uint32_t max_threads = argc > 3 ? (uint32_t)std::atoi(argv[3]) : (uint32_t)omp_get_num_procs();
+
+	sim::BlockSparseMatrix A;
+	build_system(grid_size, Float(1), Float(100), &A);
+	const Vec b = Vec::Ones(A.rows());
+	std::printf("%u nodes, %u blocks\n", A.block_rows(), A.num_blocks());
+	std::printf("%8s %10s %10s %12s %12s %8s\n", "threads", "variant", "iterations", "ms/solve", "ms/iteration", "speedup");
+
+	const sim::ConjugateGradientVariant variants[] = {
+		sim::ConjugateGradientVariant::Classic, sim::ConjugateGradientVariant::Pipelined };
+	const char* names[] = { "classic", "pipelined" };
+	double single_thread_ms[2] = { 0.0, 0.0 };
+
+	// Powers of two, and the maximum
+	for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+		threads = std::min(threads, max_threads);
+		omp_set_num_threads((int)threads);
+		for (uint32_t v = 0; v < 2; ++v) {
+			const Measure m = measure(A, b, variants[v], num_solves);
+			if (threads == 1) {
+				single_thread_ms[v] = m.ms_per_solve;
+			}
+			std::printf("%8u %10s %10u %12.3f %12.4f %8.2f\n", threads, names[v], m.iterations,
+				m.ms_per_solve, m.ms_per_solve / std::max(m.iterations, 1u), single_thread_ms[v] / m.ms_per_solve);
+		}
+		if (threads == max_threads) {
+			break;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+#include "BlockSparseMatrix.hpp"
+
+#include <omp.h>
+#include <algorithm>
+#include <cassert>
+
+namespace sim {
+
+void BlockSparseMatrix::set_pattern(const std::vector<std::vector<uint32_t>>& row_columns, bool upper_only)
+{
+	std::shared_ptr<Pattern> pattern = std::make_shared<Pattern>();
+	pattern->upper_only = upper_only;
+
+	// First stored column of each row
+	const auto row_first = [&row_columns, upper_only](size_t i) {
+		assert(std::is_sorted(row_columns[i].begin(), row_columns[i].end()));
+		return upper_only ?
+			std::lower_bound(row_columns[i].begin(), row_columns[i].end(), (uint32_t)i) :
+			row_columns[i].begin();
+	};
+
+	pattern->row_offsets.resize(row_columns.size() + 1);
+	pattern->row_offsets[0] = 0;
+	for (size_t i = 0; i < row_columns.size(); ++i) {
+		const uint32_t count = (uint32_t)(row_columns[i].end() - row_first(i));
+		pattern->row_offsets[i + 1] = pattern->row_offsets[i] + count;
+	}
+
+	pattern->columns.reserve(pattern->row_offsets.back());
+	pattern->diagonal.resize(row_columns.size());
+	for (size_t i = 0; i < row_columns.size(); ++i) {
+		const auto first = row_first(i);
+		const auto it = std::lower_bound(first, row_columns[i].end(), (uint32_t)i);
+		assert(it != row_columns[i].end() && *it == (uint32_t)i);
+		pattern->diagonal[i] = pattern->row_offsets[i] + (uint32_t)(it - first);
+
+		pattern->columns.insert(pattern->columns.end(), first, row_columns[i].end());
+	}
+
+	if (upper_only) {
+		// Transposed access to the blocks above the diagonal, by block column
+		pattern->transpose_offsets.assign(row_columns.size() + 1, 0);
+		for (size_t i = 0; i < row_columns.size(); ++i) {
+			for (uint32_t b = pattern->diagonal[i] + 1; b < pattern->row_offsets[i + 1]; ++b) {
+				pattern->transpose_offsets[pattern->columns[b] + 1] += 1;
+			}
+		}
+		for (size_t i = 0; i < row_columns.size(); ++i) {
+			pattern->transpose_offsets[i + 1] += pattern->transpose_offsets[i];
+		}
+
+		pattern->transpose_blocks.resize(pattern->transpose_offsets.back());
+		pattern->transpose_rows.resize(pattern->transpose_offsets.back());
+		std::vector<uint32_t> cursor(pattern->transpose_offsets.begin(), pattern->transpose_offsets.end() - 1);
+		for (size_t i = 0; i < row_columns.size(); ++i) {
+			for (uint32_t b = pattern->diagonal[i] + 1; b < pattern->row_offsets[i + 1]; ++b) {
+				const uint32_t t = cursor[pattern->columns[b]]++;
+				pattern->transpose_blocks[t] = b;
+				pattern->transpose_rows[t] = (uint32_t)i;
+			}
+		}
+	}
+
+	m_pattern = std::move(pattern);
+	m_values.assign(9 * (size_t)m_pattern->columns.size(), Float(0));
+}
+
+uint32_t BlockSparseMatrix::block_index(uint32_t i, uint32_t j) const
+{
+	assert(!this->upper_only() || i <= j);
+	const std::vector<uint32_t>& columns = m_pattern->columns;
+	const auto begin = columns.begin() + this->row_begin(i);
+	const auto end = columns.begin() + this->row_end(i);
+	const auto it = std::lower_bound(begin, end, j);
+	assert(it != end && *it == j);
+	return (uint32_t)(it - columns.begin());
+}
+
+void BlockSparseMatrix::set_zero()
+{
+	std::fill(m_values.begin(), m_values.end(), Float(0));
+}
+
+void BlockSparseMatrix::multiply(const Vec& x, Vec* y) const
+{
+	assert(x.size() == this->cols());
+	y->resize(this->rows());
+
+#pragma omp parallel
+	{
+		const uint32_t threads = (uint32_t)omp_get_num_threads();
+		const uint32_t chunk = (this->block_rows() + threads - 1) / threads;
+		const uint32_t begin = std::min(this->block_rows(), (uint32_t)omp_get_thread_num() * chunk);
+		this->multiply_rows(x, begin, std::min(this->block_rows(), begin + chunk), y);
+	}
+}
+
+Float BlockSparseMatrix::multiply_rows(const Vec& x, uint32_t begin, uint32_t end, Vec* y) const
+{
+	assert(x.size() == this->cols() && y->size() == this->rows());
+	const Pattern& pattern = *m_pattern;
+
+	// With half storage, the blocks below the diagonal are read transposed from the block column,
+	// so each block row is still only written by one thread
+	Float dot = Float(0);
+	for (uint32_t i = begin; i < end; ++i) {
+		Vec3 sum = Vec3::Zero();
+		for (uint32_t b = this->row_begin(i); b < this->row_end(i); ++b) {
+			sum.noalias() += this->block(b) * x.segment<3>(3 * (Eigen::Index)this->block_column(b));
+		}
+		if (pattern.upper_only) {
+			for (uint32_t t = pattern.transpose_offsets[i]; t < pattern.transpose_offsets[i + 1]; ++t) {
+				sum.noalias() += this->block(pattern.transpose_blocks[t]).transpose() *
+					x.segment<3>(3 * (Eigen::Index)pattern.transpose_rows[t]);
+			}
+		}
+		y->segment<3>(3 * (Eigen::Index)i) = sum;
+		dot += x.segment<3>(3 * (Eigen::Index)i).dot(sum);
+	}
+	return dot;
+}
+
+void BlockSparseMatrix::diagonal(Vec* d) const
+{
+	d->resize(this->rows());
+	for (uint32_t i = 0; i < this->block_rows(); ++i) {
+		d->segment<3>(3 * (Eigen::Index)i) = this->diagonal_block(i).diagonal();
+	}
+}
+
+void BlockSparseMatrix::to_sparse(SMat* out) const
+{
+	std::vector<Eigen::Triplet<Float>> triplets;
+	triplets.reserve(this->upper_only() ? 2 * m_values.size() : m_values.size());
+	for (uint32_t i = 0; i < this->block_rows(); ++i) {
+		for (uint32_t b = this->row_begin(i); b < this->row_end(i); ++b) {
+			const uint32_t j = this->block_column(b);
+			const ConstBlockRef block = this->block(b);
+			for (uint32_t s = 0; s < 3; ++s) {
+				for (uint32_t t = 0; t < 3; ++t) {
+					triplets.emplace_back(3 * i + t, 3 * j + s, block(t, s));
+					if (this->upper_only() && i != j) {
+						triplets.emplace_back(3 * j + s, 3 * i + t, block(t, s));
+					}
+				}
+			}
+		}
+	}
+
+	out->resize(this->rows(), this->cols());
+	out->setFromTriplets(triplets.begin(), triplets.end());
+}
+
+} // namespace sim
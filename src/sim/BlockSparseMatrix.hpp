@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <memory>
+#include <vector>
+
+#include "IFEM.hpp"
+
+namespace sim {
+
+// Square sparse matrix made of dense 3x3 blocks, one per pair of nodes, stored by block rows (BSR).
+// The values of each block are stored contiguously in column major order.
+// Copies of the matrix share the sparsity pattern, and only duplicate the values.
+// A symmetric matrix can store only its upper block triangle, the blocks (i, j) with i <= j.
+class BlockSparseMatrix {
+public:
+	typedef Eigen::Map<Mat3> BlockRef;
+	typedef Eigen::Map<const Mat3> ConstBlockRef;
+
+	BlockSparseMatrix() = default;
+
+	// Sets the sparsity pattern, given the sorted block columns of each block row.
+	// If upper_only, the pattern must be symmetric and the blocks below the diagonal are dropped.
+	// All the values are set to zero.
+	void set_pattern(const std::vector<std::vector<uint32_t>>& row_columns, bool upper_only = false);
+
+	// True if there is no pattern set
+	bool empty() const { return m_pattern == nullptr; }
+
+	// True if only the upper block triangle is stored
+	bool upper_only() const { return m_pattern != nullptr && m_pattern->upper_only; }
+
+	// True if both matrices share the same sparsity pattern object
+	bool same_pattern(const BlockSparseMatrix& other) const { return m_pattern == other.m_pattern; }
+
+	// Keeps the sparsity pattern alive without the values, to check later if a matrix still uses it
+	typedef std::shared_ptr<const void> PatternHandle;
+	PatternHandle pattern_handle() const { return m_pattern; }
+	bool has_pattern(const PatternHandle& handle) const { return m_pattern == handle; }
+
+	uint32_t block_rows() const { return (uint32_t)m_pattern->row_offsets.size() - 1; }
+	Eigen::Index rows() const { return 3 * (Eigen::Index)this->block_rows(); }
+	Eigen::Index cols() const { return this->rows(); }
+	uint32_t num_blocks() const { return (uint32_t)m_pattern->columns.size(); }
+
+	// Blocks of the block row i are in the range [row_begin(i), row_end(i))
+	uint32_t row_begin(uint32_t i) const { return m_pattern->row_offsets[i]; }
+	uint32_t row_end(uint32_t i) const { return m_pattern->row_offsets[i + 1]; }
+	uint32_t block_column(uint32_t b) const { return m_pattern->columns[b]; }
+
+	// Index of the block (i, j), which must be part of the pattern.
+	// If upper_only(), then i <= j.
+	uint32_t block_index(uint32_t i, uint32_t j) const;
+	uint32_t diagonal_index(uint32_t i) const { return m_pattern->diagonal[i]; }
+
+	// If upper_only(), the blocks (j, i) with j < i, the transposed blocks of the block row i,
+	// are in the range [transpose_begin(i), transpose_end(i))
+	uint32_t transpose_begin(uint32_t i) const { return m_pattern->transpose_offsets[i]; }
+	uint32_t transpose_end(uint32_t i) const { return m_pattern->transpose_offsets[i + 1]; }
+	uint32_t transpose_block(uint32_t t) const { return m_pattern->transpose_blocks[t]; }
+	uint32_t transpose_row(uint32_t t) const { return m_pattern->transpose_rows[t]; }
+
+	BlockRef block(uint32_t b) { return BlockRef(m_values.data() + 9 * (size_t)b); }
+	ConstBlockRef block(uint32_t b) const { return ConstBlockRef(m_values.data() + 9 * (size_t)b); }
+	BlockRef diagonal_block(uint32_t i) { return this->block(this->diagonal_index(i)); }
+	ConstBlockRef diagonal_block(uint32_t i) const { return this->block(this->diagonal_index(i)); }
+
+	Float* values() { return m_values.data(); }
+	const Float* values() const { return m_values.data(); }
+
+	void set_zero();
+
+	// y = A * x
+	void multiply(const Vec& x, Vec* y) const;
+
+	// Block rows [begin, end) of y = A * x, and returns their part of the dot product x^T * y
+	Float multiply_rows(const Vec& x, uint32_t begin, uint32_t end, Vec* y) const;
+
+	// Scalar diagonal of the matrix
+	void diagonal(Vec* d) const;
+
+	// Builds the equivalent scalar sparse matrix, with all the blocks
+	void to_sparse(SMat* out) const;
+
+private:
+
+	struct Pattern {
+		// Offsets of the first block of each block row, with a last extra value
+		std::vector<uint32_t> row_offsets;
+		// Block column of each block
+		std::vector<uint32_t> columns;
+		// Index of the diagonal block of each block row
+		std::vector<uint32_t> diagonal;
+
+		bool upper_only = false;
+		// If upper_only, the blocks strictly above the diagonal in each block column i,
+		// in the range [transpose_offsets[i], transpose_offsets[i + 1]).
+		// Their block rows are in transpose_rows.
+		std::vector<uint32_t> transpose_offsets;
+		std::vector<uint32_t> transpose_blocks;
+		std::vector<uint32_t> transpose_rows;
+	};
+
+	std::shared_ptr<const Pattern> m_pattern;
+	std::vector<Float> m_values;
+};
+
+} // namespace sim
@@ -0,0 +1,203 @@
+#include "ElementBatch.hpp"
+
+#include "EnergyDensity.hpp"
+
+namespace sim {
+
+namespace {
+
+typedef FloatBatch B;
+
+// First Piola-Kirchhoff stress and its derivative of each element of the batch,
+// both flattened in column major order
+struct EnergyBatch {
+	std::array<B, 9> pk1;
+	std::array<B, 81> hessian;
+};
+
+inline void cross(const B* a, const B* b, B* out)
+{
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+// Accumulates s * cross_matrix(v) into the 3x3 block (r, c) of the 9x9 matrix H
+inline void add_cross_block(std::array<B, 81>& H, uint32_t r, uint32_t c, const B* v, const B& s)
+{
+	const auto at = [&H, r, c](uint32_t i, uint32_t j) -> B& {
+		return H[9 * (3 * c + j) + 3 * r + i];
+	};
+	at(0, 1) -= s * v[2];
+	at(0, 2) += s * v[1];
+	at(1, 0) += s * v[2];
+	at(1, 2) -= s * v[0];
+	at(2, 0) -= s * v[1];
+	at(2, 1) += s * v[0];
+}
+
+// Energies whose stress and hessian have the form
+//     P = mu * F + c * g3
+//     H = mu * I + a * g3 * g3^T + c * H3
+// where g3 and H3 are the gradient and hessian of I3 = det(F), and a and c only depend on I3
+template<typename Coefficients>
+inline void invariant_energy(const std::array<B, 9>& F, Float mu,
+	const Coefficients& coefficients, EnergyBatch* out)
+{
+	const B* f0 = &F[0];
+	const B* f1 = &F[3];
+	const B* f2 = &F[6];
+
+	std::array<B, 9> g3;
+	cross(f1, f2, &g3[0]);
+	cross(f2, f0, &g3[3]);
+	cross(f0, f1, &g3[6]);
+	const B I3 = f0[0] * g3[0] + f0[1] * g3[1] + f0[2] * g3[2];
+
+	B a, c;
+	coefficients(I3, &a, &c);
+
+	for (uint32_t i = 0; i < 9; ++i) {
+		out->pk1[i] = mu * F[i] + c * g3[i];
+	}
+
+	std::array<B, 81>& H = out->hessian;
+	for (uint32_t j = 0; j < 9; ++j) {
+		const B ag3 = a * g3[j];
+		for (uint32_t i = 0; i < 9; ++i) {
+			H[9 * j + i] = ag3 * g3[i];
+		}
+		H[9 * j + j] += mu;
+	}
+
+	const B minus_c = -c;
+	add_cross_block(H, 0, 1, f2, minus_c);
+	add_cross_block(H, 0, 2, f1, c);
+	add_cross_block(H, 1, 0, f2, c);
+	add_cross_block(H, 1, 2, f0, minus_c);
+	add_cross_block(H, 2, 0, f1, minus_c);
+	add_cross_block(H, 2, 1, f0, c);
+}
+
+// Evaluate the energy element by element, for the energies that need decompositions of F
+template<EnergyFunction Function>
+inline void lane_energy(const std::array<B, 9>& F, Float mu, Float lambda, EnergyBatch* out)
+{
+	EnergyDensity energy;
+	for (uint32_t l = 0; l < ELEMENT_BATCH_SIZE; ++l) {
+		Mat3 F_l;
+		for (uint32_t i = 0; i < 9; ++i) {
+			F_l.data()[i] = F[i][l];
+		}
+
+		energy.compute<Function>(F_l, mu, lambda);
+
+		for (uint32_t i = 0; i < 9; ++i) {
+			out->pk1[i][l] = energy.pk1().data()[i];
+		}
+		for (uint32_t i = 0; i < 81; ++i) {
+			out->hessian[i][l] = energy.hessian().data()[i];
+		}
+	}
+}
+
+} // namespace
+
+template<EnergyFunction Function>
+void compute_element_batch(const ElementBatch& batch, Float mu, Float lambda,
+	Mat12* dfdx, Vec12* f)
+{
+	const std::array<B, 9>& DmInv = batch.DmInv;
+
+	// F = Ds * DmInv, with Ds = [x1 - x0, x2 - x0, x3 - x0]
+	std::array<B, 9> Ds;
+	for (uint32_t c = 0; c < 3; ++c) {
+		for (uint32_t i = 0; i < 3; ++i) {
+			Ds[3 * c + i] = batch.x[3 * (c + 1) + i] - batch.x[i];
+		}
+	}
+	std::array<B, 9> F;
+	for (uint32_t a = 0; a < 3; ++a) {
+		for (uint32_t i = 0; i < 3; ++i) {
+			F[3 * a + i] = Ds[i] * DmInv[3 * a] + Ds[3 + i] * DmInv[3 * a + 1] + Ds[6 + i] * DmInv[3 * a + 2];
+		}
+	}
+
+	// Compute the energy function
+	EnergyBatch energy;
+	if constexpr (Function == EnergyFunction::HookeanSmith19) {
+		invariant_energy(F, mu, [mu, lambda](const B& I3, B* a, B* c) {
+			*a = B::Constant(lambda);
+			*c = lambda * (I3 - Float(1)) - mu;
+			}, &energy);
+	}
+	else if constexpr (Function == EnergyFunction::HookeanBW08) {
+		invariant_energy(F, mu, [mu, lambda](const B& I3, B* a, B* c) {
+			const B logI3 = I3.log();
+			*a = (mu + lambda * (Float(1) - logI3)) / (I3 * I3);
+			*c = (lambda * logI3 - mu) / I3;
+			}, &energy);
+	}
+	else {
+		lane_energy<Function>(F, mu, lambda, &energy);
+	}
+
+	// dF/dx only has the values of G, where dF(i, a)/dx(b, j) = delta_ij * G(b, a).
+	// G(0, a) = -sum_c DmInv(c, a) and G(c + 1, a) = DmInv(c, a)
+	std::array<B, 12> G;
+	for (uint32_t a = 0; a < 3; ++a) {
+		G[a] = -(DmInv[3 * a] + DmInv[3 * a + 1] + DmInv[3 * a + 2]);
+		for (uint32_t c = 0; c < 3; ++c) {
+			G[3 * (c + 1) + a] = DmInv[3 * a + c];
+		}
+	}
+
+	// T = dF/dx^T * H, as a row major 12x9 matrix
+	const std::array<B, 81>& H = energy.hessian;
+	std::array<B, 108> T;
+	for (uint32_t b = 0; b < 4; ++b) {
+		for (uint32_t j = 0; j < 3; ++j) {
+			B* row = &T[9 * (3 * b + j)];
+			for (uint32_t s = 0; s < 9; ++s) {
+				row[s] = G[3 * b] * H[9 * s + j] + G[3 * b + 1] * H[9 * s + 3 + j] + G[3 * b + 2] * H[9 * s + 6 + j];
+			}
+		}
+	}
+
+	// df/dx = -vol * T * dF/dx, which is symmetric
+	const B minus_vol = -batch.volume;
+	for (uint32_t r = 0; r < 12; ++r) {
+		const B* row = &T[9 * r];
+		for (uint32_t col = r; col < 12; ++col) {
+			const uint32_t d = col / 3;
+			const uint32_t l = col % 3;
+			const B value = minus_vol * (row[l] * G[3 * d] + row[3 + l] * G[3 * d + 1] + row[6 + l] * G[3 * d + 2]);
+			for (uint32_t lane = 0; lane < ELEMENT_BATCH_SIZE; ++lane) {
+				dfdx[lane](r, col) = value[lane];
+				dfdx[lane](col, r) = value[lane];
+			}
+		}
+	}
+
+	// f = -vol * dF/dx^T * vec(P)
+	const std::array<B, 9>& P = energy.pk1;
+	for (uint32_t b = 0; b < 4; ++b) {
+		for (uint32_t j = 0; j < 3; ++j) {
+			const B value = minus_vol * (G[3 * b] * P[j] + G[3 * b + 1] * P[3 + j] + G[3 * b + 2] * P[6 + j]);
+			for (uint32_t lane = 0; lane < ELEMENT_BATCH_SIZE; ++lane) {
+				f[lane](3 * b + j) = value[lane];
+			}
+		}
+	}
+}
+
+template void compute_element_batch<EnergyFunction::HookeanSmith19>(
+	const ElementBatch&, Float, Float, Mat12*, Vec12*);
+template void compute_element_batch<EnergyFunction::Corrotational>(
+	const ElementBatch&, Float, Float, Mat12*, Vec12*);
+template void compute_element_batch<EnergyFunction::HookeanSmith19Eigen>(
+	const ElementBatch&, Float, Float, Mat12*, Vec12*);
+template void compute_element_batch<EnergyFunction::HookeanBW08>(
+	const ElementBatch&, Float, Float, Mat12*, Vec12*);
+
+} // namespace sim
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <Eigen/Dense>
+
+#include "IFEM.hpp"
+
+namespace sim {
+
+// Number of elements that are evaluated together by the batched kernel, one per SIMD lane
+constexpr uint32_t ELEMENT_BATCH_SIZE = sizeof(Float) == 4 ? 8 : 4;
+typedef Eigen::Array<Float, ELEMENT_BATCH_SIZE, 1> FloatBatch;
+
+// Data of ELEMENT_BATCH_SIZE elements in structure of arrays layout.
+// Each FloatBatch holds the same value for all the elements of the batch.
+struct ElementBatch {
+	// Coordinate i of the node a of the elements is x[3 * a + i]
+	std::array<FloatBatch, 12> x;
+	// Inverse of the rest shape matrix Dm, in column major order
+	std::array<FloatBatch, 9> DmInv;
+	FloatBatch volume;
+};
+
+// Computes the force derivative df/dx and the force f of all the elements of the batch.
+// Both dfdx and f must point to arrays of ELEMENT_BATCH_SIZE values.
+// The energy functions that need an SVD or an eigendecomposition are evaluated lane by lane,
+// and the rest of the computation is still batched.
+template<EnergyFunction Function>
+void compute_element_batch(const ElementBatch& batch, Float mu, Float lambda,
+	Mat12* dfdx, Vec12* f);
+
+} // namespace sim
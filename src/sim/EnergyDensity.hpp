@@ -0,0 +1,379 @@
+#pragma once
+
+#include <glm/gtc/constants.hpp>
+#include <cassert>
+
+#include "IFEM.hpp"
+#include "utils/sifakis_svd.hpp"
+
+namespace sim {
+
+inline Float compute_I1(const Mat3& S) { return S.trace(); }
+inline Float compute_I2(const Mat3& F) { return (F.transpose() * F).trace(); }
+inline Float compute_I3(const Mat3& F) { return F.determinant(); }
+
+inline const Eigen::Reshaped<const Mat3, 9, 1> compute_g1(const Mat3& R) { return R.reshaped(); }
+inline const Vec9 compute_g2(const Mat3& F) { return Float(2.0) * F.reshaped(); }
+Vec9 compute_g3(const Mat3& F);
+
+Mat9 compute_H1(const Mat3& U, const Vec3& singular_values, const Mat3& V);
+inline Mat9 compute_H2() { return Float(2.0) * Mat9::Identity(); }
+Mat9 compute_H3(const Mat3& F);
+
+Mat3 cross_matrix(const Vec3& v);
+
+// The energy functions are defined in this header so that the element loops,
+// which are instantiated per energy function, can inline them.
+class EnergyDensity {
+public:
+	void HookeanSmith19(const Mat3& F, Float mu, Float lambda);
+	void HookeanSmith19Eigendecomposition(const Mat3& F, Float mu, Float lambda);
+	void Corrotational(const Mat3& F, Float mu, Float lambda);
+	void HookeanBW08(const Mat3& F, Float mu, Float lambda);
+
+	template<EnergyFunction Function>
+	void compute(const Mat3& F, Float mu, Float lambda);
+
+	const Mat3& pk1() const { return this->m_pk1; }
+	const Mat9& hessian() const { return this->m_hessian; }
+
+private:
+	Mat3 m_pk1;
+	Mat9 m_hessian;
+
+};
+
+template<EnergyFunction Function>
+inline void EnergyDensity::compute(const Mat3& F, Float mu, Float lambda)
+{
+	if constexpr (Function == EnergyFunction::HookeanSmith19) {
+		this->HookeanSmith19(F, mu, lambda);
+	}
+	else if constexpr (Function == EnergyFunction::HookeanSmith19Eigen) {
+		this->HookeanSmith19Eigendecomposition(F, mu, lambda);
+	}
+	else if constexpr (Function == EnergyFunction::Corrotational) {
+		this->Corrotational(F, mu, lambda);
+	}
+	else {
+		static_assert(Function == EnergyFunction::HookeanBW08, "Unknown energy function");
+		this->HookeanBW08(F, mu, lambda);
+	}
+}
+
+inline Mat3 cross_matrix(const Vec3& v)
+{
+	Mat3 m;
+	m << 0, -v(2), v(1), 
+		v(2), 0, -v(0),
+		-v(1), v(0), 0;
+	return m;
+}
+
+inline Vec9 compute_g3(const Mat3& F)
+{
+	Vec9 g3;
+
+	g3.segment<3>(0) = F.col(1).cross(F.col(2));
+	g3.segment<3>(3) = F.col(2).cross(F.col(0));
+	g3.segment<3>(6) = F.col(0).cross(F.col(1));
+
+	return g3;
+}
+
+inline Mat9 compute_H1(const Mat3& U, const Vec3& s, const Mat3& V)
+{
+	constexpr Float invSqrt2 = glm::one_over_root_two<Float>();
+
+	Mat3 T0 = Mat3::Zero();
+	T0(0, 1) = Float(-1.0);
+	T0(1, 0) = Float(1.0);
+	T0 = invSqrt2 * U * T0 * V.transpose();
+
+	Mat3 T1 = Mat3::Zero();
+	T1(2, 1) = Float(-1.0);
+	T1(1, 2) = Float(1.0);
+	T1 = invSqrt2 * U * T1 * V.transpose();
+
+	Mat3 T2 = Mat3::Zero();
+	T2(2, 0) = Float(-1.0);
+	T2(0, 2) = Float(1.0);
+	T2 = invSqrt2 * U * T2 * V.transpose();
+
+	// flatten
+	const Eigen::Reshaped<Mat3, 9, 1> t0 = T0.reshaped();
+	const Eigen::Reshaped<Mat3, 9, 1> t1 = T1.reshaped();
+	const Eigen::Reshaped<Mat3, 9, 1> t2 = T2.reshaped();
+
+	Mat9 H = (Float(2) / (s.x() + s.y())) * (t0 * t0.transpose());
+	H += (Float(2) / (s.y() + s.z())) * (t1 * t1.transpose());
+	H += (Float(2) / (s.z() + s.x())) * (t2 * t2.transpose());
+
+	return H;
+}
+
+inline Mat9 compute_H3(const Mat3& F)
+{
+	Mat9 H3 = Mat9::Zero();
+
+	Mat3 f0 = cross_matrix(F.col(0));
+	Mat3 f1 = cross_matrix(F.col(1));
+	Mat3 f2 = cross_matrix(F.col(2));
+
+	H3.block<3, 3>(0, 3) = -f2;
+	H3.block<3, 3>(0, 6) = f1;
+	H3.block<3, 3>(3, 0) = f2;
+	H3.block<3, 3>(3, 6) = -f0;
+	H3.block<3, 3>(6, 0) = -f1;
+	H3.block<3, 3>(6, 3) = f0;
+
+	return H3;
+}
+
+inline void EnergyDensity::Corrotational(const Mat3& F, Float mu, Float lambda)
+{
+	// Eigen::JacobiSVD<Mat3> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
+
+	Eigen::Matrix3f F_float = F.cast<float>();
+	Eigen::Matrix3f U_float, V_float;
+	Eigen::Vector3f s_float;
+	SifakisSVD::svd<4>(
+		F_float(0, 0), F_float(0, 1), F_float(0, 2),
+		F_float(1, 0), F_float(1, 1), F_float(1, 2),
+		F_float(2, 0), F_float(2, 1), F_float(2, 2),
+
+		U_float(0, 0), U_float(0, 1), U_float(0, 2),
+		U_float(1, 0), U_float(1, 1), U_float(1, 2),
+		U_float(2, 0), U_float(2, 1), U_float(2, 2),
+
+		V_float(0, 0), V_float(0, 1), V_float(0, 2),
+		V_float(1, 0), V_float(1, 1), V_float(1, 2),
+		V_float(2, 0), V_float(2, 1), V_float(2, 2),
+
+		s_float[0], s_float[1], s_float[2]);
+		
+
+
+	Mat3 U = U_float.cast<Float>();
+	Vec3 s = s_float.cast<Float>();
+	Mat3 V = V_float.cast<Float>();
+
+	const Float detU = U.determinant();
+	const Float detV = V.determinant();
+	if (detU < Float(0.0) && detV > Float(0.0)) {
+		s[2] *= Float(-1);
+		U.row(2) *= Float(-1);
+	}
+	else if (detU > Float(0.0) && detV < Float(0.0)) {
+		s[2] *= Float(-1);
+		V.row(2) *= Float(-1);
+	}
+
+	Mat3 R = U * V.transpose();
+	Mat3 S = V * s.asDiagonal() * V.transpose();
+
+	Float I1 = compute_I1(S);
+	Vec9 g1 = compute_g1(R);
+	Vec9 g2 = compute_g2(F);
+	Mat9 H1 = compute_H1(U, s, V);
+	Mat9 H2 = compute_H2();
+
+	m_hessian = lambda * (g1 * g1.transpose()) + (lambda * (I1 - Float(3)) - mu) * H1 + (mu / Float(2)) * H2;
+	
+	typedef Eigen::Reshaped<const Vec9, 3, 3, Eigen::ColMajor> Reshaped3;
+	const Reshaped3 g1_3x3 = Reshaped3(g1);
+	const Reshaped3 g2_3x3 = Reshaped3(g2);
+	m_pk1 = (lambda * (I1 - Float(3)) - mu) * g1_3x3 + (mu / Float(2)) * g2_3x3;
+}
+
+inline void EnergyDensity::HookeanSmith19(const Mat3& F, Float mu, Float lambda)
+{
+	const Float I3 = compute_I3(F);
+	const Vec9 g2 = compute_g2(F);
+	const Vec9 g3 = compute_g3(F);
+	const Mat9 H2 = compute_H2();
+	const Mat9 H3 = compute_H3(F);
+
+
+	const Float dPdI2 = mu / Float(2);
+	const Float dPdI3 = -mu + lambda * (I3 - Float(1));
+	const Float ddPddI3 = lambda;
+
+	typedef Eigen::Reshaped<const Vec9, 3, 3, Eigen::ColMajor> Reshaped3;
+
+	const auto g2_ = Reshaped3(g2);
+	const auto g3_ = Reshaped3(g3);
+
+	this->m_pk1 = dPdI2 * g2_ + dPdI3 * g3_;
+	this->m_hessian = dPdI2 * H2 + ddPddI3 * g3 * g3.transpose() + dPdI3 * H3;
+}
+
+inline void EnergyDensity::HookeanSmith19Eigendecomposition(const Mat3& F, Float mu, Float lambda)
+{
+	const Float I3 = compute_I3(F);
+	const Vec9 g2 = compute_g2(F);
+	const Vec9 g3 = compute_g3(F);
+	const Mat9 H2 = compute_H2();
+	const Mat9 H3 = compute_H3(F);
+
+
+	const Float dPdI2 = mu / Float(2);
+	const Float dPdI3 = -mu + lambda * (I3 - Float(1));
+	const Float ddPddI3 = lambda;
+
+	typedef Eigen::Reshaped<const Vec9, 3, 3, Eigen::ColMajor> Reshaped3;
+
+	const auto g2_ = Reshaped3(g2);
+	const auto g3_ = Reshaped3(g3);
+
+	this->m_pk1 = dPdI2 * g2_ + dPdI3 * g3_;
+
+	Eigen::JacobiSVD<Mat3> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
+
+	Mat3 U = svd.matrixU();
+	Vec3 s = svd.singularValues();
+	Mat3 V = svd.matrixV();
+
+	const Float detU = U.determinant();
+	const Float detV = V.determinant();
+	if (detU < Float(0.0) && detV > Float(0.0)) {
+		s[2] *= Float(-1);
+		U.row(2) *= Float(-1);
+	}
+	else if (detU > Float(0.0) && detV < Float(0.0)) {
+		s[2] *= Float(-1);
+		V.row(2) *= Float(-1);
+	}
+
+	Mat3 scaling_eigensystem;
+	for (uint32_t i = 0; i < 3; ++i) {
+		scaling_eigensystem(i, i) = mu + lambda * I3 * I3 / (s[i] * s[i]);
+	}
+	scaling_eigensystem(0, 1) = s[2] * (lambda * (2 * I3 - Float(1)) - mu);
+	scaling_eigensystem(1, 0) = s[2] * (lambda * (2 * I3 - Float(1)) - mu);
+	scaling_eigensystem(0, 2) = s[1] * (lambda * (2 * I3 - Float(1)) - mu);
+	scaling_eigensystem(2, 0) = s[1] * (lambda * (2 * I3 - Float(1)) - mu);
+	scaling_eigensystem(1, 2) = s[0] * (lambda * (2 * I3 - Float(1)) - mu);
+	scaling_eigensystem(2, 1) = s[0] * (lambda * (2 * I3 - Float(1)) - mu);
+
+
+
+	const auto eigenvalues_scaling = scaling_eigensystem.eigenvalues();
+
+	Vec9 eigenvalues;
+	eigenvalues[0] = eigenvalues_scaling[0].real();
+	eigenvalues[1] = eigenvalues_scaling[1].real();
+	eigenvalues[2] = eigenvalues_scaling[2].real();
+	eigenvalues[3] = mu + s[2] * (lambda * (I3 - Float(1)) - mu);
+	eigenvalues[4] = mu + s[0] * (lambda * (I3 - Float(1)) - mu);
+	eigenvalues[5] = mu + s[1] * (lambda * (I3 - Float(1)) - mu);
+	eigenvalues[6] = mu - s[2] * (lambda * (I3 - Float(1)) - mu);
+	eigenvalues[7] = mu - s[0] * (lambda * (I3 - Float(1)) - mu);
+	eigenvalues[8] = mu - s[1] * (lambda * (I3 - Float(1)) - mu);
+
+	bool all_eigenvalues_positive = true;
+	for (uint32_t i = 0; i < 9; ++i) {
+		all_eigenvalues_positive &= (eigenvalues[i] >= -Float(1e-6));
+		eigenvalues[i] = std::max(eigenvalues[i], std::numeric_limits<Float>::epsilon());
+	}
+
+	if (all_eigenvalues_positive) {
+		this->m_hessian = dPdI2 * H2 + ddPddI3 * g3 * g3.transpose() + dPdI3 * H3;
+	}
+	else {
+		this->m_hessian.setZero();
+
+		/*Vec3 depressed_cubic;
+		for (uint32_t i = 0; i < 3; ++i) {
+			depressed_cubic[i] = Float(2) * std::sqrt(I2 / Float(3)) * std::cos(
+				1 / Float(3) * (std::acos(Float(3) * I3 / I2 * std::sqrt(Float(3) / I2)) +
+				2 * glm::pi<Float>() * (Float(i) - Float(1))
+					));
+			assert(depressed_cubic[i] == depressed_cubic[i]);
+		}*/
+
+		std::array<Mat3, 3> D;
+
+		D[0] = U;
+		for (uint32_t i = 0; i < 3; ++i) D[0].col(i) *= V.transpose()(0, i);
+		D[1] = U;
+		for (uint32_t i = 0; i < 3; ++i) D[1].col(i) *= V.transpose()(1, i);
+		D[2] = U;
+		for (uint32_t i = 0; i < 3; ++i) D[2].col(i) *= V.transpose()(2, i);	
+
+		// First 3 eigenmatrices
+		Mat3 Q;
+		for (uint32_t i = 0; i < 3; ++i) {
+			Q.setZero();
+			Vec3 z;
+			z[0] = s[0] * s[2] + s[1] * eigenvalues[i];
+			z[1] = s[1] * s[2] + s[0] * eigenvalues[i];
+			z[2] = eigenvalues[i] * eigenvalues[i] - s[2] * s[2];
+
+			for (uint32_t j = 0; j < 3; ++j) {
+				Q += z[j] * D[j];
+			}
+
+			Q.normalize();
+			assert(std::abs(Q.squaredNorm() - Float(1)) < Float(1e-6));
+			m_hessian += eigenvalues[i] * Q.reshaped() * Q.reshaped().transpose();
+		}
+
+		// 3rd eigenmatrix
+		Mat3 r;
+		r.row(0) = -V.col(1);
+		r.row(1) = V.col(0);
+		r.row(2).setZero();
+		Q = glm::one_over_root_two<Float>() * U * r; assert(std::abs(Q.squaredNorm() - Float(1)) < Float(1e-6));
+		m_hessian += eigenvalues[3] * Q.reshaped() * Q.reshaped().transpose();
+		// 4rt eigenmatrix
+		r.row(0).setZero();
+		r.row(1) = V.col(2);
+		r.row(2) = -V.col(1);
+		Q = glm::one_over_root_two<Float>() * U * r; assert(std::abs(Q.squaredNorm() - Float(1)) < Float(1e-6));
+		m_hessian += eigenvalues[4] * Q.reshaped() * Q.reshaped().transpose();
+		// 5th eigenmatrix
+		r.row(0) = V.col(2);
+		r.row(1).setZero();
+		r.row(2) = -V.col(0);
+		Q = glm::one_over_root_two<Float>() * U * r; assert(std::abs(Q.squaredNorm() - Float(1)) < Float(1e-6));
+		m_hessian += eigenvalues[5] * Q.reshaped() * Q.reshaped().transpose();
+		// 6th eigenmatrix
+		r.row(0) = V.col(1);
+		r.row(1) = V.col(0);
+		r.row(2).setZero();
+		Q = glm::one_over_root_two<Float>() * U * r; assert(std::abs(Q.squaredNorm() - Float(1)) < Float(1e-6));
+		m_hessian += eigenvalues[6] * Q.reshaped() * Q.reshaped().transpose();
+		// 7th eigenmatrix
+		r.row(0).setZero();
+		r.row(1) = V.col(2);
+		r.row(2) = V.col(1);
+		Q = glm::one_over_root_two<Float>() * U * r; assert(std::abs(Q.squaredNorm() - Float(1)) < Float(1e-6));
+		m_hessian += eigenvalues[7] * Q.reshaped() * Q.reshaped().transpose();
+		// 8th eigenmatrix
+		r.row(0) = V.col(2);
+		r.row(1).setZero();
+		r.row(2) = V.col(0);
+		Q = glm::one_over_root_two<Float>() * U * r; assert(std::abs(Q.squaredNorm() - Float(1)) < Float(1e-6));
+
+		m_hessian += eigenvalues[8] * Q.reshaped() * Q.reshaped().transpose();
+	}
+}
+
+inline void EnergyDensity::HookeanBW08(const Mat3& F, Float mu, Float lambda)
+{
+	const Float I3 = compute_I3(F);
+	const Float logI3 = std::log(I3);
+	const Vec9 g3 = compute_g3(F);
+	const Mat9 H3 = compute_H3(F);
+
+	typedef Eigen::Reshaped<const Vec9, 3, 3, Eigen::ColMajor> Reshaped3;
+
+	m_pk1 = mu * F + (lambda * logI3 - mu) / I3 * Reshaped3(g3);
+
+	const Float g_fact = (mu + lambda * (Float(1.0) - logI3)) / (I3 * I3);
+	const Float H_fact = (lambda * logI3 - mu) / I3;
+	m_hessian = mu * Mat9::Identity() + g_fact * g3 * g3.transpose() + H_fact * H3;
+}
+
+} // namespace sim
@@ -1,165 +1,345 @@
-#pragma once
-
-#include <Eigen/Dense>
-#include <Eigen/Sparse>
-#include <glm/glm.hpp>
-
-#include "meshes/TetMesh.hpp"
-#include "utils/serialization.hpp"
-
-namespace sim
-{
-
-typedef double Float;
-typedef Eigen::SparseMatrix<Float> SMat;
-typedef Eigen::SparseVector<Float> SVec;
-typedef Eigen::Matrix<Float, Eigen::Dynamic, 1> Vec;
-typedef Eigen::Matrix<Float, 3, 1> Vec3;
-typedef Eigen::Matrix<Float, 9, 1> Vec9;
-typedef Eigen::Matrix<Float, 12, 1> Vec12;
-typedef Eigen::Vector4i Vec4i;
-typedef Eigen::Matrix<Float, 3, 3> Mat3;
-typedef Eigen::Matrix<Float, 9, 9> Mat9;
-typedef Eigen::Matrix<Float, 12, 12> Mat12;
-typedef Eigen::Matrix<Float, 9, 12> Mat9x12;
-
-inline glm::vec3 cast_vec3(const Vec3& v) { return glm::vec3((float)v.x(), (float)v.y(), (float)v.z()); }
-inline Vec3 cast_vec3(const glm::vec3& v) { return Vec3(v.x, v.y, v.z); }
-
-Mat9x12 compute_dFdx(const Mat3& DmInv);
-
-inline Mat3 compute_Ds(const Vec4i& element, const std::vector<Vec3>& nodes) {
-	Mat3 Ds;
-	Ds.col(0) = nodes[element(1)] - nodes[element(0)];
-	Ds.col(1) = nodes[element(2)] - nodes[element(0)];
-	Ds.col(2) = nodes[element(3)] - nodes[element(0)];
-
-	return Ds;
-}
-
-Vec9 vec_slow(const Mat3& m);
-Mat3 cross_matrix(const Vec3& v);
-
-inline Float compute_I1(const Mat3& S) { return S.trace(); }
-inline Float compute_I2(const Mat3& F) { return (F.transpose() * F).trace(); }
-inline Float compute_I3(const Mat3& F) { return F.determinant(); }
-
-inline const Eigen::Reshaped<const Mat3, 9, 1> compute_g1(const Mat3& R) { return R.reshaped(); }
-inline const Vec9 compute_g2(const Mat3& F) { return Float(2.0) * F.reshaped(); }
-Vec9 compute_g3(const Mat3& F);
-
-Mat9 compute_H1(const Mat3& U, const Vec3& singular_values, const Mat3& V);
-inline Mat9 compute_H2() { return Float(2.0) * Mat9::Identity(); }
-Mat9 compute_H3(const Mat3& F);
-
-class Parameters;
-class IFEM {
-public:
-
-	virtual void step(Float dt, const Parameters& params) = 0;
-
-	virtual void initialize(const std::vector<const TetMesh*>& meshes) = 0;
-
-	virtual void update_objects(TetMesh* mesh,
-		uint32_t from_sim_idx, uint32_t to_sim_idx,
-		bool add_position_alteration = false) = 0;
-
-	// Add a velocity constraint 
-	virtual void add_constraint(uint32_t node, const glm::vec3& v, 
-		const glm::vec3& dir,
-		Float friction = Float(0)) = 0;
-	// Constrain all degrees of freedom
-	virtual void add_constraint(uint32_t node, const glm::vec3& v) = 0;
-	virtual void erase_constraint(uint32_t node) = 0;
-	virtual void add_position_alteration(uint32_t node, const glm::vec3& dx) = 0;
-	virtual const Vec3& get_node(uint32_t node) const = 0;
-	virtual Vec3 get_velocity(uint32_t node) const = 0;
-	virtual Vec3 get_force_constraint(uint32_t node) const = 0;
-
-	virtual Float compute_volume() const = 0;
-
-	virtual void clear_frame_alterations() = 0;
-
-	struct MetricTimes {
-		float step = 0.0f;
-		float set_zero = 0.0f;
-		float blocks_assign = 0.0f;
-		float system_finish = 0.0f;
-		float constraints = 0.0f;
-		float solve = 0.0f;
-	};
-	MetricTimes get_metric_times() const { return m_metric_time; }
-	bool simulation_converged() const { return m_converged; }
-
-protected:
-	MetricTimes m_metric_time;
-	bool m_converged = true;
-};
-
-class EnergyDensity {
-public:
-	void HookeanSmith19(const Mat3& F, Float mu, Float lambda);
-	void HookeanSmith19Eigendecomposition(const Mat3& F, Float mu, Float lambda);
-	void Corrotational(const Mat3& F, Float mu, Float lambda);
-	void HookeanBW08(const Mat3& F, Float mu, Float lambda);
-
-	const Mat3& pk1() const { return this->m_pk1; }
-	const Mat9& hessian() const { return this->m_hessian; }
-
-private:
-	Mat3 m_pk1;
-	Mat9 m_hessian;
-
-};
-
-enum EnergyFunction {
-	HookeanSmith19 = 0,
-	Corrotational = 1,
-	HookeanSmith19Eigen = 2,
-	HookeanBW08 = 3,
-};
-
-class Parameters {
-public:
-	Parameters() { this->update_lame(); }
-	Parameters(Float young, Float nu) :
-		m_young(young), m_nu(nu) { this->update_lame(); }
-
-	const Float& young() const { return m_young; }
-	const Float& nu() const { return m_nu; }
-	const Float& gravity() const { return m_gravity; }
-	const Float& mu() const { return m_mu; }
-	const Float& lambda() const { return m_lambda; }
-	const Float& alpha_rayleigh() const { return m_alpha_rayleigh; }
-	const Float& beta_rayleigh() const { return m_beta_rayleigh; }
-	const Float& mass() const { return m_node_mass; }
-	const EnergyFunction& energy_function() const { return m_enum_energy; }
-
-	void draw_ui();
-
-
-private:
-	Float m_young;
-	Float m_nu;
-
-	Float m_node_mass = 1.0e-2f;
-	Float m_gravity = 9.8f;
-	Float m_mu = 0.0f;
-	Float m_lambda = 0.0f;
-	Float m_alpha_rayleigh = 0.01f;
-	Float m_beta_rayleigh = 0.001f;
-
-	EnergyFunction m_enum_energy = EnergyFunction::HookeanSmith19;
-
-	
-
-	void update_lame();
-
-	// Serialization
-	template<typename Archive>
-	void serialize(Archive& archive);
-
-	TF_SERIALIZE_PRIVATE_MEMBERS
-};
-
+#pragma once
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <glm/glm.hpp>
+
+#include "meshes/TetMesh.hpp"
+#include "utils/serialization.hpp"
+
+namespace sim
+{
+
+typedef double Float;
+typedef Eigen::SparseMatrix<Float> SMat;
+typedef Eigen::SparseVector<Float> SVec;
+typedef Eigen::Matrix<Float, Eigen::Dynamic, 1> Vec;
+typedef Eigen::Matrix<Float, 3, 1> Vec3;
+typedef Eigen::Matrix<Float, 9, 1> Vec9;
+typedef Eigen::Matrix<Float, 12, 1> Vec12;
+typedef Eigen::Vector4i Vec4i;
+typedef Eigen::Matrix<Float, 3, 3> Mat3;
+typedef Eigen::Matrix<Float, 9, 9> Mat9;
+typedef Eigen::Matrix<Float, 12, 12> Mat12;
+typedef Eigen::Matrix<Float, 9, 12> Mat9x12;
+
+inline glm::vec3 cast_vec3(const Vec3& v) { return glm::vec3((float)v.x(), (float)v.y(), (float)v.z()); }
+inline Vec3 cast_vec3(const glm::vec3& v) { return Vec3(v.x, v.y, v.z); }
+
+Mat9x12 compute_dFdx(const Mat3& DmInv);
+
+// Computes the force derivative df/dx = -vol * dF/dx^T * H * dF/dx and the force
+// f = -vol * dF/dx^T * vec(P) of an element, without building dF/dx.
+// dF/dx = G^T (x) I3, where the rows of the 4x3 matrix G are -sum of the rows of DmInv
+// followed by the rows of DmInv, so each 3x3 block of df/dx is a combination of blocks of H.
+inline void compute_element_forces(const Mat3& DmInv, Float volume, const Mat9& H, const Mat3& P,
+	Mat12* dfdx, Vec12* f)
+{
+	Eigen::Matrix<Float, 4, 3> G;
+	G.row(0) = -DmInv.colwise().sum();
+	G.bottomRows<3>() = DmInv;
+
+	// T = (G (x) I3) * H
+	Eigen::Matrix<Float, 12, 9> T;
+	for (uint32_t b = 0; b < 4; ++b) {
+		for (uint32_t c = 0; c < 3; ++c) {
+			T.block<3, 3>(3 * b, 3 * c) = G(b, 0) * H.block<3, 3>(0, 3 * c) +
+				G(b, 1) * H.block<3, 3>(3, 3 * c) + G(b, 2) * H.block<3, 3>(6, 3 * c);
+		}
+	}
+
+	// df/dx = -vol * T * (G^T (x) I3), which is symmetric
+	for (uint32_t b = 0; b < 4; ++b) {
+		for (uint32_t d = b; d < 4; ++d) {
+			const Mat3 K = -volume * (G(d, 0) * T.block<3, 3>(3 * b, 0) +
+				G(d, 1) * T.block<3, 3>(3 * b, 3) + G(d, 2) * T.block<3, 3>(3 * b, 6));
+			dfdx->block<3, 3>(3 * b, 3 * d) = K;
+			if (d != b) {
+				dfdx->block<3, 3>(3 * d, 3 * b) = K.transpose();
+			}
+		}
+		f->segment<3>(3 * b) = -volume * (P * G.row(b).transpose());
+	}
+}
+
+inline Mat3 compute_Ds(const Vec4i& element, const std::vector<Vec3>& nodes) {
+	Mat3 Ds;
+	Ds.col(0) = nodes[element(1)] - nodes[element(0)];
+	Ds.col(1) = nodes[element(2)] - nodes[element(0)];
+	Ds.col(2) = nodes[element(3)] - nodes[element(0)];
+
+	return Ds;
+}
+
+Vec9 vec_slow(const Mat3& m);
+
+// Why a solve of the linear system stopped
+enum class SolverStop {
+	// The residual went under the tolerance
+	Converged = 0,
+	IterationLimit = 1,
+	// The system is not positive definite in a search direction, or a value is not finite
+	Breakdown = 2,
+};
+
+// Result of the last solve of the linear system
+struct SolverStats {
+	uint32_t iterations = 0;
+	// Norm of the residual at the end of the solve, and the tolerance it was compared with
+	Float residual = Float(0);
+	Float tolerance = Float(0);
+	SolverStop stop = SolverStop::Converged;
+};
+
+class Parameters;
+class IFEM {
+public:
+
+	virtual void step(Float dt, const Parameters& params) = 0;
+
+	virtual void initialize(const std::vector<const TetMesh*>& meshes) = 0;
+
+	virtual void update_objects(TetMesh* mesh,
+		uint32_t from_sim_idx, uint32_t to_sim_idx,
+		bool add_position_alteration = false) = 0;
+
+	// Add a velocity constraint 
+	virtual void add_constraint(uint32_t node, const glm::vec3& v, 
+		const glm::vec3& dir,
+		Float friction = Float(0)) = 0;
+	// Constrain all degrees of freedom
+	virtual void add_constraint(uint32_t node, const glm::vec3& v) = 0;
+	virtual void erase_constraint(uint32_t node) = 0;
+	virtual void add_position_alteration(uint32_t node, const glm::vec3& dx) = 0;
+	virtual Vec3 get_node(uint32_t node) const = 0;
+	virtual Vec3 get_velocity(uint32_t node) const = 0;
+	virtual Vec3 get_force_constraint(uint32_t node) const = 0;
+
+	virtual Float compute_volume() const = 0;
+
+	virtual void clear_frame_alterations() = 0;
+
+	struct MetricTimes {
+		float step = 0.0f;
+		float set_zero = 0.0f;
+		float blocks_assign = 0.0f;
+		// Part of blocks_assign spent gathering the element results by node
+		float gather = 0.0f;
+		float system_finish = 0.0f;
+		float constraints = 0.0f;
+		float solve = 0.0f;
+	};
+	MetricTimes get_metric_times() const { return m_metric_time; }
+	bool simulation_converged() const { return m_converged; }
+	// Iterations of the linear solver in the last step
+	uint32_t solver_iterations() const { return m_solver_stats.iterations; }
+	const SolverStats& solver_stats() const { return m_solver_stats; }
+
+protected:
+	MetricTimes m_metric_time;
+	bool m_converged = true;
+	SolverStats m_solver_stats;
+};
+
+enum EnergyFunction {
+	HookeanSmith19 = 0,
+	Corrotational = 1,
+	HookeanSmith19Eigen = 2,
+	HookeanBW08 = 3,
+};
+
+// How the element contributions are scattered into the global system
+enum class AssemblyMode {
+	// All elements in parallel, accumulating with atomics
+	Atomic = 0,
+	// Elements grouped by colors that do not share nodes, without atomics
+	Colored = 1,
+	// Elements stored in buffers, and then gathered by the nodes that own each block row
+	Gather = 2,
+};
+
+// How the force and force derivative of each element are computed
+enum class ElementKernel {
+	// One element at a time
+	Scalar = 0,
+	// Batches of elements, one per SIMD lane
+	Batched = 1,
+};
+
+// Which blocks of the symmetric system matrix are stored
+enum class MatrixStorage {
+	// All the blocks
+	Full = 0,
+	// Only the blocks of the upper block triangle
+	SymmetricUpper = 1,
+};
+
+// Renumbering of the nodes applied when the simulation is initialized, to improve memory locality
+enum class NodeOrdering {
+	// The order of the meshes
+	Original = 0,
+	// Reverse Cuthill-McKee, which reduces the bandwidth of the system
+	ReverseCuthillMcKee = 1,
+	// Morton curve of the rest positions
+	Morton = 2,
+};
+
+// Sorting of the elements applied when the simulation is initialized, so that consecutive
+// elements share nodes in the assembly loop
+enum class ElementOrdering {
+	// The order of the meshes
+	Original = 0,
+	// Morton curve of the rest centroids
+	Morton = 1,
+};
+
+// How the constraint filter S is applied when solving the system
+enum class ConstraintFilter {
+	// The system is rewritten as S * A * S + I - S before the conjugate gradient
+	PrefilteredSystem = 0,
+	// The conjugate gradient filters its vectors, and the system is not modified
+	ModifiedPCG = 1,
+};
+
+// Solver of the linear system of each step
+enum class LinearSolver {
+	ConjugateGradient = 0,
+	// Supernodal sparse Cholesky of the pre-filtered system, with the ordering and the symbolic
+	// factorization computed once for the pattern of the system. Only in ParallelFEM, the other
+	// simulators use the conjugate gradient. It replaces the modified PCG by the pre-filtered system.
+	// It is currently slower than the conjugate gradient on volumetric meshes, several times even
+	// for stiff materials, as the fill of the factorization grows quickly with the mesh size
+	SparseCholesky = 1,
+};
+
+// Preconditioner of the conjugate gradient solvers
+enum class Preconditioner {
+	// Inverse of the diagonal
+	Jacobi = 0,
+	// Inverses of the 3x3 diagonal blocks of the nodes
+	BlockJacobi = 1,
+	// Block incomplete Cholesky IC(0) on the pattern of the system. Falls back to block Jacobi
+	// when the system is not an assembled block sparse matrix, or the factorization fails
+	IncompleteCholesky = 2,
+	// Smoothed aggregation multigrid V-cycle, with the same fall back as IncompleteCholesky
+	AlgebraicMultigrid = 3,
+};
+
+// Formulation of the iteration of the conjugate gradient
+enum class ConjugateGradientVariant {
+	// Two reductions per iteration, the first one waits for the product by the system
+	Classic = 0,
+	// Pipelined [Ghysels and Vanroose 2014], with a single reduction per iteration that does not
+	// wait for the product by the system. It needs more vectors and is less accurate in the residual
+	Pipelined = 1,
+};
+
+// When the conjugate gradient solvers stop, from the norm of the residual r = b - A * x
+enum class StoppingCriterion {
+	// |r| < absolute tolerance
+	Absolute = 0,
+	// |r| < relative tolerance * |b|
+	RelativeToRhs = 1,
+	// |r| < relative tolerance * |r0|, with r0 the residual of the initial guess
+	RelativeToInitialResidual = 2,
+	// |r| < eta * |b|, with the forcing term eta of an inexact Newton method [Eisenstat and Walker 1996].
+	// Each step is taken as a Newton iteration, and |b| as the norm of its nonlinear residual,
+	// so eta goes down to the relative tolerance when |b| falls quickly between steps
+	Adaptive = 3,
+};
+
+// Stopping criterion with its tolerances
+struct StoppingPolicy {
+	StoppingCriterion criterion = StoppingCriterion::Absolute;
+	Float absolute_tolerance = Float(1e-2);
+	Float relative_tolerance = Float(1e-3);
+	// Zero for the number of unknowns
+	uint32_t max_iterations = 0;
+};
+
+// Initial guess of the conjugate gradient solvers, from the solutions of the previous solves
+enum class InitialGuess {
+	Zero = 0,
+	// The last solution
+	Previous = 1,
+	// Line through the last two solutions
+	LinearExtrapolation = 2,
+	// Parabola through the last three solutions
+	QuadraticExtrapolation = 3,
+	// Galerkin projection of the system onto the span of the last solutions,
+	// which costs one product by the system for each solution
+	Projection = 4,
+};
+
+class Parameters {
+public:
+	Parameters() { this->update_lame(); }
+	Parameters(Float young, Float nu) :
+		m_young(young), m_nu(nu) { this->update_lame(); }
+
+	const Float& young() const { return m_young; }
+	const Float& nu() const { return m_nu; }
+	const Float& gravity() const { return m_gravity; }
+	const Float& mu() const { return m_mu; }
+	const Float& lambda() const { return m_lambda; }
+	const Float& alpha_rayleigh() const { return m_alpha_rayleigh; }
+	const Float& beta_rayleigh() const { return m_beta_rayleigh; }
+	const Float& mass() const { return m_node_mass; }
+	const EnergyFunction& energy_function() const { return m_enum_energy; }
+	const AssemblyMode& assembly_mode() const { return m_assembly_mode; }
+	const ElementKernel& element_kernel() const { return m_element_kernel; }
+	const MatrixStorage& matrix_storage() const { return m_matrix_storage; }
+	bool deterministic() const { return m_deterministic; }
+	const ConstraintFilter& constraint_filter() const { return m_constraint_filter; }
+	bool eliminate_fixed_nodes() const { return m_eliminate_fixed_nodes; }
+	const LinearSolver& linear_solver() const { return m_linear_solver; }
+	const Preconditioner& preconditioner() const { return m_preconditioner; }
+	const InitialGuess& initial_guess() const { return m_initial_guess; }
+	const ConjugateGradientVariant& cg_variant() const { return m_cg_variant; }
+	StoppingPolicy stopping_policy() const;
+
+	void draw_ui();
+
+
+private:
+	Float m_young;
+	Float m_nu;
+
+	Float m_node_mass = 1.0e-2f;
+	Float m_gravity = 9.8f;
+	Float m_mu = 0.0f;
+	Float m_lambda = 0.0f;
+	Float m_alpha_rayleigh = 0.01f;
+	Float m_beta_rayleigh = 0.001f;
+
+	EnergyFunction m_enum_energy = EnergyFunction::HookeanSmith19;
+	AssemblyMode m_assembly_mode = AssemblyMode::Colored;
+	ElementKernel m_element_kernel = ElementKernel::Batched;
+	MatrixStorage m_matrix_storage = MatrixStorage::SymmetricUpper;
+	// Bit-identical results between runs with the same number of threads
+	bool m_deterministic = false;
+	ConstraintFilter m_constraint_filter = ConstraintFilter::PrefilteredSystem;
+	// Remove the fully constrained nodes from the unknowns of the pre-filtered system
+	bool m_eliminate_fixed_nodes = false;
+	LinearSolver m_linear_solver = LinearSolver::ConjugateGradient;
+	Preconditioner m_preconditioner = Preconditioner::Jacobi;
+	InitialGuess m_initial_guess = InitialGuess::Previous;
+	ConjugateGradientVariant m_cg_variant = ConjugateGradientVariant::Classic;
+	StoppingCriterion m_stopping_criterion = StoppingCriterion::Absolute;
+	Float m_absolute_tolerance = 1.0e-2;
+	Float m_relative_tolerance = 1.0e-3;
+	// Zero for the number of unknowns
+	uint32_t m_max_solver_iterations = 0;
+
+	
+
+	void update_lame();
+
+	// Serialization
+	template<typename Archive>
+	void serialize(Archive& archive);
+
+	TF_SERIALIZE_PRIVATE_MEMBERS
+};
+
 } // namespace sim
\ No newline at end of file
@@ -0,0 +1,548 @@
+#include "MatrixFreeFEM.hpp"
+
+#include <assert.h>
+#include <iostream>
+#include <algorithm>
+
+#include "utils/Timer.hpp"
+#include "EnergyDensity.hpp"
+#include "Reordering.hpp"
+
+namespace sim {
+
+namespace {
+
+// The packed upper triangle of a symmetric 9x9 matrix is stored by columns,
+// so the value (r, c) with r <= c is at c * (c + 1) / 2 + r
+inline Mat9 unpack(const std::array<Float, 45>& packed)
+{
+	Mat9 H;
+	uint32_t k = 0;
+	for (uint32_t c = 0; c < 9; ++c) {
+		for (uint32_t r = 0; r <= c; ++r) {
+			H(r, c) = packed[k];
+			H(c, r) = packed[k];
+			++k;
+		}
+	}
+	return H;
+}
+
+// Matrix G of the element, where dF/dx = G^T (x) I3
+inline Eigen::Matrix<Float, 4, 3> compute_G(const Mat3& DmInv)
+{
+	Eigen::Matrix<Float, 4, 3> G;
+	G.row(0) = -DmInv.colwise().sum();
+	G.bottomRows<3>() = DmInv;
+	return G;
+}
+
+} // namespace
+
+MatrixFreeFEM::MatrixFreeFEM()
+{
+}
+
+void MatrixFreeFEM::initialize(const std::vector<const TetMesh*>& meshes)
+{
+	m_converged = true;
+
+	uint32_t num_elements = 0;
+	uint32_t num_nodes = 0;
+	std::vector<uint32_t> offsets;
+	offsets.reserve(meshes.size());
+	for (const TetMesh* mesh : meshes) {
+		assert(mesh != nullptr);
+		offsets.push_back(num_nodes);
+		num_elements += (uint32_t)mesh->elements().size();
+		num_nodes += (uint32_t)mesh->nodes().size();
+	}
+
+	// Load elements
+	m_elements.reserve(num_elements);
+	m_nodes.reserve(num_nodes);
+	for (size_t mesh_idx = 0; mesh_idx < meshes.size(); ++mesh_idx) {
+		const TetMesh* mesh = meshes[mesh_idx];
+		assert(mesh != nullptr);
+
+		for (const Eigen::Vector3f& p : mesh->nodes()) {
+			m_nodes.push_back(p.cast<Float>());
+		}
+
+		for (size_t e = 0; e < mesh->elements().size(); ++e) {
+			Vec4i element = mesh->elements()[e];
+			element[0] += offsets[mesh_idx];
+			element[1] += offsets[mesh_idx];
+			element[2] += offsets[mesh_idx];
+			element[3] += offsets[mesh_idx];
+			m_elements.push_back(element);
+		}
+	}
+
+	// Precompute volumes and matrix to build the deformation gradient
+	m_DmInvs.resize(m_elements.size());
+	m_volumes.resize(m_elements.size());
+	for (size_t i = 0; i < m_elements.size(); ++i) {
+		const Mat3 Ds = compute_Ds(m_elements[i], m_nodes);
+		m_volumes[i] = std::abs(Ds.determinant()) / Float(6.0);
+		m_DmInvs[i] = Ds.inverse();
+	}
+
+	m_hessians.resize(m_elements.size());
+	m_element_forces.resize(m_elements.size());
+	m_element_products.resize(m_elements.size());
+	m_element_diagonal.resize(m_elements.size());
+	m_diagonal.resize(3 * m_nodes.size());
+
+	m_v.resize(3 * m_nodes.size());
+	m_v.setZero();
+	m_delta_v.resize(3 * m_nodes.size());
+	m_delta_v.setZero();
+	m_rhs.resize(3 * m_nodes.size());
+	m_z.resize(3 * m_nodes.size()); m_z.setZero();
+	m_constraint_slots.assign(m_nodes.size(), NO_CONSTRAINT);
+	m_position_alteration.resize(3 * m_nodes.size());
+	m_constraint_forces.resize(3 * m_nodes.size());
+
+	m_tmp.resize(3 * m_nodes.size());
+	m_filter_tmp.resize(3 * m_nodes.size());
+	m_filter_out.resize(3 * m_nodes.size());
+
+	build_node_elements(m_elements, (uint32_t)m_nodes.size(), &m_node_element_offsets, &m_node_elements);
+
+	m_cg_solver.resize(3 * m_nodes.size());
+}
+
+template<EnergyFunction Function>
+void MatrixFreeFEM::compute_elements(const Parameters& cfg)
+{
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)m_elements.size(); ++i) {
+		EnergyDensity energy;
+		const Mat3 F = compute_Ds(m_elements[i], m_nodes) * m_DmInvs[i];
+		energy.compute<Function>(F, cfg.mu(), cfg.lambda());
+
+		// Keep vol * H, which is enough to apply df/dx = -vol * dF/dx^T * H * dF/dx
+		const Mat9& H = energy.hessian();
+		PackedMat9& packed = m_hessians[i];
+		uint32_t k = 0;
+		for (uint32_t c = 0; c < 9; ++c) {
+			for (uint32_t r = 0; r <= c; ++r) {
+				packed[k++] = m_volumes[i] * H(r, c);
+			}
+		}
+
+		// f = -vol * dF/dx^T * vec(P)
+		// and the diagonal of the blocks (a, a) of df/dx, -vol * sum_cd G(a, c) * G(a, d) * H(3c + j, 3d + j)
+		const Eigen::Matrix<Float, 4, 3> G = compute_G(m_DmInvs[i]);
+		for (uint32_t a = 0; a < 4; ++a) {
+			m_element_forces[i].segment<3>(3 * a) = -m_volumes[i] * (energy.pk1() * G.row(a).transpose());
+
+			for (uint32_t j = 0; j < 3; ++j) {
+				Float value = Float(0);
+				for (uint32_t c = 0; c < 3; ++c) {
+					for (uint32_t d = 0; d < 3; ++d) {
+						value += G(a, c) * G(a, d) * H(3 * c + j, 3 * d + j);
+					}
+				}
+				m_element_diagonal[i](3 * a + j) = -m_volumes[i] * value;
+			}
+		}
+	}
+}
+
+void MatrixFreeFEM::step(Float dt, const Parameters& cfg)
+{
+	Timer step_timer;
+	Timer timer;
+
+	m_metric_time.set_zero = 0.0f;
+
+	// We are solving the system
+	// 	   [M - Δt * df/dv - Δt^2 * df/dx] * Δv = Δt * f + Δt^2 * df/dx * v + Δt * df/dx * y
+	// without assembling it. Only the hessians of the elements are stored.
+
+	// Compute the hessian and forces of each element
+	switch (cfg.energy_function()) {
+	case EnergyFunction::HookeanSmith19:
+		this->compute_elements<EnergyFunction::HookeanSmith19>(cfg);
+		break;
+	case EnergyFunction::Corrotational:
+		this->compute_elements<EnergyFunction::Corrotational>(cfg);
+		break;
+	case EnergyFunction::HookeanSmith19Eigen:
+		this->compute_elements<EnergyFunction::HookeanSmith19Eigen>(cfg);
+		break;
+	case EnergyFunction::HookeanBW08:
+		this->compute_elements<EnergyFunction::HookeanBW08>(cfg);
+		break;
+	}
+
+	m_metric_time.blocks_assign = (float)timer.getDuration<Timer::Seconds>().count();
+	timer.reset();
+
+	// Rayleigh damping df/dv = -alpha * M - beta * df/dx, so the system is
+	//				M * (1 - Δt * alpha) - df/dx * (Δt^2 + Δt * beta)
+	m_mass_coef = cfg.mass() * (Float(1.0) - cfg.alpha_rayleigh() * dt);
+	m_stiffness_coef = -(dt * dt) - cfg.beta_rayleigh() * dt;
+	m_dt = dt;
+
+	// Gather the forces and the diagonal of the system of each node
+#pragma omp parallel for
+	for (int32_t n = 0; n < (int32_t)m_nodes.size(); ++n) {
+		Vec3 f = Vec3::Zero();
+		Vec3 dfdx_diagonal = Vec3::Zero();
+		for (uint32_t k = m_node_element_offsets[n]; k < m_node_element_offsets[n + 1]; ++k) {
+			const uint32_t e = m_node_elements[k] / 4;
+			const uint32_t a = m_node_elements[k] % 4;
+			f += m_element_forces[e].segment<3>(3 * a);
+			dfdx_diagonal += m_element_diagonal[e].segment<3>(3 * a);
+		}
+
+		m_rhs.segment<3>(3 * n) = dt * f;
+		// subtract gravity from the y entries
+		m_rhs(3 * n + 1) -= dt * cfg.mass() * cfg.gravity();
+
+		m_diagonal.segment<3>(3 * n) = m_stiffness_coef * dfdx_diagonal;
+		m_diagonal.segment<3>(3 * n).array() += m_mass_coef;
+	}
+
+	// Add tangential friction forces f = -k * v
+	// And tangential friction damping as df/dv= -k * (I - n · n^T)
+	for (const Constraint& c : m_constraints) {
+		if (c.friction != Float(0)) {
+			const Float k = c.friction;
+			m_diagonal.segment<3>(3 * c.node) += dt * k * c.constraint.diagonal();
+
+			m_rhs.segment<3>(3 * c.node) -= dt * k * m_v.segment<3>(3 * c.node);
+		}
+	}
+
+	// add Δt^2 * (df/dx * v) + Δt * df/dx * y to the rhs
+	m_tmp.noalias() = dt * m_v;
+	m_tmp += m_position_alteration;
+	this->multiply_stiffness(m_tmp, &m_Sc);
+	m_rhs.noalias() += dt * m_Sc;
+
+	m_metric_time.system_finish = (float)timer.getDuration<Timer::Seconds>().count();
+	timer.reset();
+
+	// Pre-filtered Preconditioned Conjugate Gradient
+	// (SAS^T + I - S)y = Sc
+	//                y = x - z
+	//                c = b - Az
+	this->multiply_system(m_z, &m_tmp);
+	m_tmp = m_rhs - m_tmp;
+	this->apply_filter(m_tmp, &m_Sc);
+
+	m_metric_time.constraints = (float)timer.getDuration<Timer::Seconds>().count();
+	timer.reset();
+
+	m_cg_solver.set_preconditioner(cfg.preconditioner());
+	m_cg_solver.set_initial_guess(cfg.initial_guess());
+	m_cg_solver.set_variant(cfg.cg_variant());
+	m_cg_solver.set_stopping_policy(cfg.stopping_policy());
+	m_converged = m_cg_solver.solve(FilteredSystem(this), m_Sc, &m_delta_v);
+	m_solver_stats = m_cg_solver.stats();
+
+	if (!m_converged) {
+		std::cerr << "System did not converge" << std::endl;
+	}
+
+	m_v += m_delta_v + m_z;
+
+	m_metric_time.solve = (float)timer.getDuration<Timer::Seconds>().count();
+	timer.reset();
+
+	// Compute constraint forces
+	if (m_constraints.empty()) {
+		m_constraint_forces.setZero();
+	}
+	else {
+		this->multiply_system(m_delta_v, &m_constraint_forces);
+		m_constraint_forces -= m_rhs;
+	}
+
+	// Assign new positions to the nodes
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)m_nodes.size(); ++i) {
+		m_nodes[i].x() += dt * m_v[3 * i + 0];
+		m_nodes[i].y() += dt * m_v[3 * i + 1];
+		m_nodes[i].z() += dt * m_v[3 * i + 2];
+	}
+
+	// Set position alteration
+	for (SVec::InnerIterator it(m_position_alteration); it;)
+	{
+		const uint32_t node_idx = (uint32_t)it.index() / 3;
+		// There must be values for the x y z
+		m_nodes[node_idx].x() += it.value(); ++it;
+		m_nodes[node_idx].y() += it.value(); ++it;
+		m_nodes[node_idx].z() += it.value(); ++it;
+	}
+
+	m_metric_time.step = (float)step_timer.getDuration<Timer::Seconds>().count();
+}
+
+void MatrixFreeFEM::multiply_stiffness(const Vec& x, Vec* y) const
+{
+	y->resize(x.size());
+
+	// Apply each element, and then gather the results of the elements of each node
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)m_elements.size(); ++i) {
+		const Vec4i& element = m_elements[i];
+		const Eigen::Matrix<Float, 4, 3> G = compute_G(m_DmInvs[i]);
+
+		// vec(dF) = dF/dx * x
+		Vec9 dF;
+		for (uint32_t c = 0; c < 3; ++c) {
+			dF.segment<3>(3 * c) = G(0, c) * x.segment<3>(3 * element[0]) +
+				G(1, c) * x.segment<3>(3 * element[1]) +
+				G(2, c) * x.segment<3>(3 * element[2]) +
+				G(3, c) * x.segment<3>(3 * element[3]);
+		}
+
+		// q = vol * H * vec(dF)
+		const PackedMat9& H = m_hessians[i];
+		Vec9 q = Vec9::Zero();
+		uint32_t k = 0;
+		for (uint32_t c = 0; c < 9; ++c) {
+			for (uint32_t r = 0; r < c; ++r) {
+				q(r) += H[k] * dF(c);
+				q(c) += H[k] * dF(r);
+				++k;
+			}
+			q(c) += H[k++] * dF(c);
+		}
+
+		// -dF/dx^T * q
+		for (uint32_t a = 0; a < 4; ++a) {
+			m_element_products[i].segment<3>(3 * a) =
+				-(G(a, 0) * q.segment<3>(0) + G(a, 1) * q.segment<3>(3) + G(a, 2) * q.segment<3>(6));
+		}
+	}
+
+#pragma omp parallel for
+	for (int32_t n = 0; n < (int32_t)m_nodes.size(); ++n) {
+		Vec3 sum = Vec3::Zero();
+		for (uint32_t k = m_node_element_offsets[n]; k < m_node_element_offsets[n + 1]; ++k) {
+			sum += m_element_products[m_node_elements[k] / 4].segment<3>(3 * (m_node_elements[k] % 4));
+		}
+		y->segment<3>(3 * n) = sum;
+	}
+}
+
+void MatrixFreeFEM::multiply_system(const Vec& x, Vec* y) const
+{
+	this->multiply_stiffness(x, y);
+	*y = m_mass_coef * x + m_stiffness_coef * (*y);
+
+	for (const Constraint& c : m_constraints) {
+		if (c.friction != Float(0)) {
+			const uint32_t idx = 3 * c.node;
+			y->segment<3>(idx) += m_dt * c.friction * (c.constraint * x.segment<3>(idx));
+		}
+	}
+}
+
+void MatrixFreeFEM::apply_filter(const Vec& x, Vec* y) const
+{
+	*y = x;
+	for (const Constraint& c : m_constraints) {
+		const uint32_t idx = 3 * c.node;
+		y->segment<3>(idx) = c.constraint * x.segment<3>(idx);
+	}
+}
+
+void MatrixFreeFEM::FilteredSystem::multiply(const Vec& x, Vec* y) const
+{
+	// S * A * S * x + x - S * x
+	m_fem->apply_filter(x, &m_fem->m_filter_tmp);
+	m_fem->multiply_system(m_fem->m_filter_tmp, &m_fem->m_filter_out);
+	m_fem->apply_filter(m_fem->m_filter_out, y);
+	*y += x - m_fem->m_filter_tmp;
+}
+
+void MatrixFreeFEM::FilteredSystem::diagonal(Vec* d) const
+{
+	*d = m_fem->m_diagonal;
+
+	// The filtered diagonal of the constrained nodes needs their whole diagonal block
+	for (const Constraint& c : m_fem->m_constraints) {
+		const Mat3& S = c.constraint;
+		const Mat3 block = S * m_fem->compute_diagonal_block(c.node) * S + Mat3::Identity() - S;
+		d->segment<3>(3 * c.node) = block.diagonal();
+	}
+}
+
+void MatrixFreeFEM::FilteredSystem::diagonal_blocks(std::vector<Mat3>* blocks) const
+{
+	blocks->resize(m_fem->m_nodes.size());
+#pragma omp parallel for
+	for (int32_t n = 0; n < (int32_t)m_fem->m_nodes.size(); ++n) {
+		(*blocks)[n] = m_fem->compute_diagonal_block(n);
+	}
+
+	for (const Constraint& c : m_fem->m_constraints) {
+		const Mat3& S = c.constraint;
+		(*blocks)[c.node] = S * (*blocks)[c.node] * S + Mat3::Identity() - S;
+	}
+}
+
+Mat3 MatrixFreeFEM::compute_diagonal_block(uint32_t node) const
+{
+	Mat3 dfdx = Mat3::Zero();
+	for (uint32_t k = m_node_element_offsets[node]; k < m_node_element_offsets[node + 1]; ++k) {
+		const uint32_t e = m_node_elements[k] / 4;
+		const uint32_t a = m_node_elements[k] % 4;
+
+		// Block (a, a) of df/dx = -sum_cd G(a, c) * G(a, d) * vol * H(3c:, 3d:)
+		const Eigen::Matrix<Float, 4, 3> G = compute_G(m_DmInvs[e]);
+		const Mat9 H = unpack(m_hessians[e]);
+		for (uint32_t c = 0; c < 3; ++c) {
+			const Mat3 T = G(a, 0) * H.block<3, 3>(3 * c, 0) +
+				G(a, 1) * H.block<3, 3>(3 * c, 3) + G(a, 2) * H.block<3, 3>(3 * c, 6);
+			dfdx -= G(a, c) * T;
+		}
+	}
+
+	Mat3 block = m_stiffness_coef * dfdx;
+	block.diagonal().array() += m_mass_coef;
+
+	const Constraint* c = this->find_constraint(node);
+	if (c != nullptr && c->friction != Float(0)) {
+		block += m_dt * c->friction * c->constraint;
+	}
+	return block;
+}
+
+void MatrixFreeFEM::update_objects(TetMesh* mesh,
+	uint32_t from_sim_idx, uint32_t to_sim_idx,
+	bool add_position_alteration)
+{
+	assert(mesh != nullptr);
+
+	add_position_alteration = add_position_alteration && m_position_alteration.nonZeros() > 0;
+
+	for (uint32_t i = from_sim_idx; i < to_sim_idx; ++i) {
+		Eigen::Vector3f pos = m_nodes[i].cast<float>();
+		if (add_position_alteration) {
+			pos.x() += (float)m_position_alteration.coeff(3 * i + 0);
+			pos.y() += (float)m_position_alteration.coeff(3 * i + 1);
+			pos.z() += (float)m_position_alteration.coeff(3 * i + 2);
+		}
+		mesh->update_node((int32_t)(i - from_sim_idx), pos);
+	}
+}
+
+void MatrixFreeFEM::add_constraint(uint32_t node, const glm::vec3& v,
+	const glm::vec3& dir, Float friction)
+{
+	m_z(3 * node + 0) = v.x - m_v[3 * node + 0];
+	m_z(3 * node + 1) = v.y - m_v[3 * node + 1];
+	m_z(3 * node + 2) = v.z - m_v[3 * node + 2];
+
+	const Vec3 d(dir.x, dir.y, dir.z);
+
+	this->set_constraint(
+		Constraint{
+			node,
+			d,
+			Mat3::Identity() - (d * d.transpose()),
+			friction
+		}
+	);
+}
+
+void MatrixFreeFEM::add_constraint(uint32_t node, const glm::vec3& v)
+{
+	const Constraint* c = this->find_constraint(node);
+	if (c != nullptr && (c->dir.isZero() || c->dir.dot(cast_vec3(v)) < Float(0.0))) {
+		return;
+	}
+
+	m_z(3 * node + 0) = v.x - m_v[3 * node + 0];
+	m_z(3 * node + 1) = v.y - m_v[3 * node + 1];
+	m_z(3 * node + 2) = v.z - m_v[3 * node + 2];
+
+	this->set_constraint(
+		Constraint{
+			node,
+			Vec3::Zero(),
+			Mat3::Zero()
+		}
+	);
+}
+
+void MatrixFreeFEM::erase_constraint(uint32_t node)
+{
+	this->remove_constraint(node);
+}
+
+void MatrixFreeFEM::set_constraint(const Constraint& constraint)
+{
+	uint32_t& slot = m_constraint_slots[constraint.node];
+	if (slot == NO_CONSTRAINT) {
+		slot = (uint32_t)m_constraints.size();
+		m_constraints.push_back(constraint);
+	}
+	else {
+		m_constraints[slot] = constraint;
+	}
+}
+
+void MatrixFreeFEM::remove_constraint(uint32_t node)
+{
+	const uint32_t slot = m_constraint_slots[node];
+	if (slot == NO_CONSTRAINT) {
+		return;
+	}
+
+	m_constraints[slot] = m_constraints.back();
+	m_constraint_slots[m_constraints[slot].node] = slot;
+	m_constraints.pop_back();
+	m_constraint_slots[node] = NO_CONSTRAINT;
+}
+
+void MatrixFreeFEM::add_position_alteration(uint32_t node, const glm::vec3& dx)
+{
+	m_position_alteration.coeffRef(3 * node + 0) = dx.x;
+	m_position_alteration.coeffRef(3 * node + 1) = dx.y;
+	m_position_alteration.coeffRef(3 * node + 2) = dx.z;
+}
+
+void MatrixFreeFEM::clear_frame_alterations()
+{
+	m_z.setZero();
+	m_position_alteration.setZero();
+}
+
+Vec3 MatrixFreeFEM::get_node(uint32_t node) const
+{
+	return m_nodes[node];
+}
+
+Vec3 MatrixFreeFEM::get_velocity(uint32_t node) const
+{
+	return m_v.segment<3>(3 * node);
+}
+
+Vec3 MatrixFreeFEM::get_force_constraint(uint32_t node) const
+{
+	assert(this->find_constraint(node) != nullptr);
+	return m_constraint_forces.segment<3>(node * 3);
+}
+
+Float MatrixFreeFEM::compute_volume() const
+{
+	Float vol = Float(0);
+	for (size_t i = 0; i < m_elements.size(); ++i) {
+		const Mat3 Ds = compute_Ds(m_elements[i], m_nodes);
+		vol += std::abs(Ds.determinant()) / Float(6.0);
+	}
+
+	return vol;
+}
+
+} // namespace sim
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "IFEM.hpp"
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <array>
+#include <limits>
+
+#include "meshes/TetMesh.hpp"
+#include "solvers/ConjugateGradient.hpp"
+
+namespace sim {
+
+// Implicit FEM that never assembles the global system.
+// The element loop only keeps the hessian of the energy density of each element,
+// and the conjugate gradient applies the system element by element.
+class MatrixFreeFEM final : public IFEM {
+public:
+
+	MatrixFreeFEM();
+
+	void initialize(const std::vector<const TetMesh*>& meshes) override final;
+
+	void step(Float dt, const Parameters& params) override final;
+
+	void update_objects(TetMesh* mesh,
+		uint32_t from_sim_idx, uint32_t to_sim_idx,
+		bool add_position_alteration) override final;
+
+	void add_constraint(uint32_t node, const glm::vec3& v,
+		const glm::vec3& dir, Float friction) override final;
+
+	void add_constraint(uint32_t node, const glm::vec3& v) override final;
+
+	void erase_constraint(uint32_t node) override final;
+
+	void add_position_alteration(uint32_t node, const glm::vec3& dx) override final;
+
+	void clear_frame_alterations() override final;
+
+	Vec3 get_node(uint32_t node) const override final;
+	Vec3 get_velocity(uint32_t node) const override final;
+	Vec3 get_force_constraint(uint32_t node) const override final;
+
+	Float compute_volume() const override final;
+
+private:
+
+	// Upper triangle of a symmetric 9x9 matrix, packed by columns
+	typedef std::array<Float, 45> PackedMat9;
+
+	Vec m_delta_v;
+	Vec m_v;
+	Vec m_rhs;
+	struct Constraint;
+	// Compact list of the active constraints, in no particular order
+	std::vector<Constraint> m_constraints;
+	// Index in m_constraints of the constraint of each node, or NO_CONSTRAINT
+	std::vector<uint32_t> m_constraint_slots;
+	static constexpr uint32_t NO_CONSTRAINT = std::numeric_limits<uint32_t>::max();
+	Vec m_Sc;
+	Vec m_constraint_forces;
+	Vec m_z;
+	SVec m_position_alteration;
+
+	Vec m_tmp;
+
+	std::vector<Mat3> m_DmInvs;
+	std::vector<Float> m_volumes;
+
+	std::vector<Eigen::Vector4i> m_elements;
+	std::vector<Vec3> m_nodes;
+
+	// Elements that contain each node, as 4 * element + local index of the node.
+	// The ones of node n are in the range [m_node_element_offsets[n], m_node_element_offsets[n + 1])
+	std::vector<uint32_t> m_node_element_offsets;
+	std::vector<uint32_t> m_node_elements;
+
+	// Hessian of the energy density of each element, scaled by its volume
+	std::vector<PackedMat9> m_hessians;
+	// Forces of each element, gathered by node afterwards
+	std::vector<Vec12> m_element_forces;
+	// Per element results of multiply_stiffness, gathered by node afterwards
+	mutable std::vector<Vec12> m_element_products;
+	// Diagonal of the 4 diagonal 3x3 blocks of the df/dx of each element
+	std::vector<Vec12> m_element_diagonal;
+	// Diagonal of the system
+	Vec m_diagonal;
+
+	// Coefficients of the system A = mass_coef * M + stiffness_coef * df/dx + dt * friction
+	Float m_mass_coef = Float(0);
+	Float m_stiffness_coef = Float(0);
+	Float m_dt = Float(0);
+
+	ConjugateGradient m_cg_solver;
+
+	struct Constraint {
+		uint32_t node;
+		Vec3 dir;
+		Mat3 constraint;
+		Float friction = Float(0);
+	};
+
+	// The filtered system S * A * S + I - S, seen by the conjugate gradient
+	class FilteredSystem final : public ConjugateGradient::LinearOperator {
+	public:
+		FilteredSystem(const MatrixFreeFEM* fem) : m_fem(fem) {}
+		Eigen::Index rows() const override final { return 3 * (Eigen::Index)m_fem->m_nodes.size(); }
+		void multiply(const Vec& x, Vec* y) const override final;
+		void diagonal(Vec* d) const override final;
+		void diagonal_blocks(std::vector<Mat3>* blocks) const override final;
+	private:
+		const MatrixFreeFEM* m_fem;
+	};
+	// Buffers of the filtered products
+	mutable Vec m_filter_tmp;
+	mutable Vec m_filter_out;
+
+	template<EnergyFunction Function>
+	void compute_elements(const Parameters& cfg);
+
+	// y = df/dx * x
+	void multiply_stiffness(const Vec& x, Vec* y) const;
+
+	// y = A * x, with A the unfiltered system
+	void multiply_system(const Vec& x, Vec* y) const;
+
+	// y = S * x, with the constraint filters
+	void apply_filter(const Vec& x, Vec* y) const;
+
+	// Diagonal 3x3 block of the system of a node
+	Mat3 compute_diagonal_block(uint32_t node) const;
+
+	// Constraint of a node, or nullptr if it is not constrained
+	const Constraint* find_constraint(uint32_t node) const {
+		const uint32_t slot = m_constraint_slots[node];
+		return slot != NO_CONSTRAINT ? &m_constraints[slot] : nullptr;
+	}
+
+	// Adds or replaces the constraint of constraint.node
+	void set_constraint(const Constraint& constraint);
+
+	// Removes the constraint of a node, moving the last constraint of the list to its slot
+	void remove_constraint(uint32_t node);
+
+};
+
+} // namespace sim
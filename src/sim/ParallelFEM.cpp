@@ -1,520 +1,1067 @@
-﻿#include "ParallelFEM.hpp"
-
-#undef NDEBUG
-#include <assert.h>
-#include <iostream>
-#include <imgui.h>
-#include <glm/gtc/constants.hpp>
-
-#include "utils/Timer.hpp"
-
-namespace sim {
-
-ParallelFEM::ParallelFEM()
-{
-}
-
-void ParallelFEM::initialize(const std::vector<const TetMesh*>& meshes)
-{
-	m_converged = true;
-
-	uint32_t num_elements = 0;
-	uint32_t num_nodes = 0;
-	std::vector<uint32_t> offsets;
-	offsets.reserve(meshes.size());
-	for (const TetMesh* mesh : meshes) {
-		assert(mesh != nullptr);
-		offsets.push_back(num_nodes);
-		num_elements += (uint32_t)mesh->elements().size();
-		num_nodes += (uint32_t)mesh->nodes().size();
-	}
-
-	// Load elements
-	m_elements.reserve(num_elements);
-	m_nodes.reserve(num_nodes);
-	for (size_t mesh_idx = 0; mesh_idx < meshes.size(); ++mesh_idx) {
-		const TetMesh* mesh = meshes[mesh_idx];
-		assert(mesh != nullptr);
-
-		for (const Eigen::Vector3f& p : mesh->nodes()) {
-			m_nodes.push_back(p.cast<Float>());
-		}
-
-		for (size_t e = 0; e < mesh->elements().size(); ++e) {
-			Vec4i element = mesh->elements()[e];
-			element[0] += offsets[mesh_idx];
-			element[1] += offsets[mesh_idx];
-			element[2] += offsets[mesh_idx];
-			element[3] += offsets[mesh_idx];
-			m_elements.push_back(element);
-		}
-	}
-
-	// Precompute volumes and matrix to build the deformation gradient
-	m_DmInvs.resize(m_elements.size());
-	m_volumes.resize(m_elements.size());
-	for (size_t i = 0; i < m_elements.size(); ++i) {
-		const Mat3 Ds = compute_Ds(m_elements[i], m_nodes);
-		m_volumes[i] = std::abs(Ds.determinant()) / Float(6.0);
-		m_DmInvs[i] = Ds.inverse();
-	}
-
-	// Reserve enough memory to solve the linear system
-	m_dfdx_system.resize(3 * m_nodes.size(), 3 * m_nodes.size());
-	m_dfdx_system.reserve(Eigen::VectorXi::Constant(3 * m_nodes.size(), 3 * 4 * 6));
-
-	m_v.resize(3 * m_nodes.size());
-	m_v.setZero();
-	m_delta_v.resize(3 * m_nodes.size());
-	m_delta_v.setZero();
-	m_rhs.resize(3 * m_nodes.size());
-	m_z.resize(3 * m_nodes.size()); m_z.setZero();
-	m_position_alteration.resize(3 * m_nodes.size());
-	m_constraint_forces.resize(3 * m_nodes.size());
-
-	m_tmp.resize(3 * m_nodes.size());
-
-	// Build the sparse matrix
-	this->build_sparse_system();
-	m_system = m_dfdx_system;
-
-#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
-	m_cg_solver.resize(3 * m_nodes.size());
-#endif
-}
-
-
-template<typename T>
-void ParallelFEM::assign_sparse_block(const Eigen::Block<const T, 3, 3>& m, uint32_t node_i, uint32_t node_j) {
-
-	const SMatPtrs& cols = m_sparse_cache.at(std::make_pair(node_i, node_j));
-
-	for (uint32_t s = 0; s < 3; ++s) {
-		Float* col = cols[s];
-		for (uint32_t t = 0; t < 3; ++t) {
-#pragma omp atomic
-			*(col + t) += m(t, s);
-			// m_dfdx_system.coeffRef(3 * node_i + t, 3 * node_j + s) += m(t, s); // Set one by one DEBUG
-		}
-	}
-}
-
-void ParallelFEM::set_system_to_zero()
-{
-	for (Eigen::Index i = 0; i < m_dfdx_system.nonZeros(); ++i) {
-		m_dfdx_system.valuePtr()[i] = Float(0);
-	}
-}
-
-
-void ParallelFEM::step(Float dt, const Parameters& cfg)
-{
-	Timer step_timer;
-	Timer timer;
-
-	// Reset system
-	this->set_system_to_zero();
-	m_rhs.setZero();
-
-	m_metric_time.set_zero = (float)timer.getDuration<Timer::Seconds>().count();
-	timer.reset();
-
-	// We are building the system
-	// 	   [M - Δt * df/dv - Δt^2 * df/dx] * Δv = Δt * f + Δt^2 * df/dx * v + Δt * df/dx * y
-	// The last bit Δt * df/dx * y comes from the forced position alteration Δx=Δt(v0+Δv)+y
-
-	const EnergyFunction functionType = cfg.energy_function();
-	// Add contribution of each element
-#pragma omp parallel for
-	for (int32_t i = 0; i < (int32_t)m_elements.size(); ++i) {
-		EnergyDensity energy;
-		const Vec4i& element = m_elements[i];
-		const Mat3 F = compute_Ds(element, m_nodes) * m_DmInvs[i];
-		// Compute the energy function
-		if (functionType == EnergyFunction::HookeanSmith19) {
-			energy.HookeanSmith19(F, cfg.mu(), cfg.lambda());
-		}
-		else if (functionType == EnergyFunction::HookeanSmith19Eigen) {
-			energy.HookeanSmith19Eigendecomposition(F, cfg.mu(), cfg.lambda());
-		}
-		else if (functionType == EnergyFunction::Corrotational) {
-			energy.Corrotational(F, cfg.mu(), cfg.lambda());
-		}
-		else {
-			energy.HookeanBW08(F, cfg.mu(), cfg.lambda());
-		}
-
-		// Compute force derivative df/dx = -vol * ddPhi/ddx = -vol * ( dF/dx * ddPhi/ddF * dF/dx )
-		const Mat9x12 dFdx = compute_dFdx(m_DmInvs[i]);
-		const Mat9& H = energy.hessian();
-		//const Mat9 H = check_eigenvalues_BW08(F);
-		const Mat12 dfdx = -m_volumes[i] * (dFdx.transpose() * H * dFdx);
-
-		// Compute force f = -vol * dPhi/dx
-		const Mat3& pk1 = energy.pk1();
-		const Vec12 f = -m_volumes[i] * (dFdx.transpose() * pk1.reshaped());
-
-		// Assign the force gradient to the system
-		for (uint32_t j = 0; j < 4; ++j) {
-			const uint32_t node_j = element[j];
-			// add forces to rhs
-#pragma omp atomic
-			m_rhs(3 * node_j + 0) += dt * f(3 * j + 0);
-#pragma omp atomic
-			m_rhs(3 * node_j + 1) += dt * f(3 * j + 1);
-#pragma omp atomic
-			m_rhs(3 * node_j + 2) += dt * f(3 * j + 2);
-
-			// diagonal
-			assign_sparse_block(dfdx.block<3, 3>(3 * j, 3 * j), node_j, node_j);
-			// off-diagonal
-			for (uint32_t k = j + 1; k < 4; ++k) {
-				const uint32_t node_k = element[k];
-				assign_sparse_block(dfdx.block<3, 3>(3 * k, 3 * j), node_k, node_j);
-				assign_sparse_block(dfdx.block<3, 3>(3 * j, 3 * k), node_j, node_k);
-			}
-		}
-	}
-
-	m_metric_time.blocks_assign = (float)timer.getDuration<Timer::Seconds>().count();
-	timer.reset();
-	// add Δt^2 * (df/dx * v) + Δt * df/dx * y to the rhs
-	m_tmp.noalias() = dt * m_v;
-	m_tmp += m_position_alteration;	// add Δt * df/dx * y
-	m_rhs.noalias() += dt * (m_dfdx_system * m_tmp);
-
-	// Apply rayleigh damping df/dv = -alpha * M - beta * df/dx
-	// Optimized:	M - Δt^2 * df/dx - Δt * df/dv 
-	//				M - Δt^2 * df/dx - Δt * (-alpha * M - beta * df/dx)
-	//				M * (1 - Δt * alpha) - * df/dx (Δt^2 + Δt * beta)
-	m_dfdx_system *= -(dt * dt) - cfg.beta_rayleigh() * dt;
-	{
-		const Float value_alpha = cfg.mass() * (Float(1.0) - cfg.alpha_rayleigh() * dt);
-#pragma omp parallel for
-		for (int32_t i = 0; i < m_nodes.size(); ++i) {
-			const SMatPtrs& cols = m_sparse_cache.at(std::make_pair(i, i));
-			cols[0][0] += value_alpha;
-			cols[1][1] += value_alpha;
-			cols[2][2] += value_alpha;
-
-			// subtract gravity from the y entries
-			m_rhs(3 * i + 1) -= dt * cfg.mass() * cfg.gravity();
-		}
-	}
-
-	// Add tangential friction forces f = -k * v
-	// And tangential friction damping as df/dv= -k * (I - n · n^T)
-	for (const std::pair<uint32_t, Constraint>& c : m_constraints3) {
-		if (c.second.friction != Float(0)) {
-			const Float k = c.second.friction;
-			const Mat3 friction_dfdv =  dt * k * c.second.constraint;
-			assign_sparse_block(friction_dfdv.block<3, 3>(0, 0), c.first, c.first);
-
-			m_rhs.segment<3>(3 * c.first) -= dt * k * m_v.segment<3>(3 * c.first);
-		}
-	}
-
-	// Fill S
-	m_metric_time.system_finish = (float)timer.getDuration<Timer::Seconds>().count();
-	timer.reset();
-
-	// Pre-filtered Preconditioned Conjugate Gradient
-	// (SAS^T + I - S)y = Sc
-	//                y = x - z
-	//                c = b - Az
-
-	// Compute rhs
-	m_Sc.noalias() = (m_rhs - m_dfdx_system * m_z);
-	for (const std::pair<uint32_t, Constraint>& c : m_constraints3) {
-		const uint32_t idx = 3 * c.first;
-		m_Sc.segment<3>(idx) = c.second.constraint * m_Sc.segment<3>(idx);
-	}
-
-	// Apply SAS^T, S symetric
-	m_system = m_dfdx_system;
-	assert(m_system.isCompressed());
-#pragma omp parallel for
-	for (int32_t col = 0; col < m_nodes.size(); ++col) {
-		SMat::InnerIterator it0(m_system, 3 * col + 0);
-		SMat::InnerIterator it1(m_system, 3 * col + 1);
-		SMat::InnerIterator it2(m_system, 3 * col + 2);
-		std::map<uint32_t, Constraint>::const_iterator c_col = m_constraints3.find(col);
-		while (it0) {
-			uint32_t row = it0.index() / 3;
-			std::map<uint32_t, Constraint>::const_iterator c_row = m_constraints3.find(row);
-			bool needs_update = c_col != m_constraints3.end() || c_row != m_constraints3.end();
-			if (needs_update) {
-				Mat3 A;
-				for (uint32_t i = 0; i < 3; ++i) {
-					A(i, 0) = (&it0.value())[i];
-					A(i, 1) = (&it1.value())[i];
-					A(i, 2) = (&it2.value())[i];
-				}
-
-				Mat3 SAS;
-				if (c_col != m_constraints3.end() && c_row != m_constraints3.end()) {
-					SAS = c_row->second.constraint * A * c_col->second.constraint;
-				}
-				else if (c_col != m_constraints3.end()) {
-					SAS = A * c_col->second.constraint ;
-				}
-				else {
-					SAS = c_row->second.constraint * A;
-				}
-
-				for (uint32_t i = 0; i < 3; ++i) {
-					(&it0.valueRef())[i] = SAS(i, 0);
-					(&it1.valueRef())[i] = SAS(i, 1);
-					(&it2.valueRef())[i] = SAS(i, 2);
-				}
-
-				// SAS^T + I - S
-				if (row == col) {
-					for (uint32_t i = 0; i < 3; ++i) {
-						(&it0.valueRef())[i] -= c_row->second.constraint(i, 0);
-						(&it1.valueRef())[i] -= c_row->second.constraint(i, 1);
-						(&it2.valueRef())[i] -= c_row->second.constraint(i, 2);
-					}
-					(&it0.valueRef())[0] += Float(1);
-					(&it1.valueRef())[1] += Float(1);
-					(&it2.valueRef())[2] += Float(1);
-				}
-			}
-
-			// advance
-			for (uint32_t i = 0; i < 3; ++i) {
-				++it0; ++it1; ++it2;
-			}
-		}
-	}
-
-	
-	m_metric_time.constraints = (float)timer.getDuration<Timer::Seconds>().count();
-	timer.reset();
-
-#if (PARALLEL_FEM_SOLVER == CG_EIGEN)
-	m_cg_solver.compute(m_system);
-	m_cg_solver.setTolerance(1e-4);
-
-	if (m_cg_solver.info() != Eigen::Success) {
-		std::cerr << "Can't build system" << std::endl;
-		m_converged = false;
-	}
-	else {
-		m_delta_v = m_cg_solver.solveWithGuess(m_Sc, m_delta_v);
-		m_converged = m_cg_solver.info() == Eigen::Success;
-	}
-#elif (PARALLEL_FEM_SOLVER == CG_CUSTOM)
-
-	m_converged = m_cg_solver.solve(m_system, m_Sc, &m_delta_v);
-#endif
-
-	if (!m_converged) {
-		std::cerr << "System did not converge" << std::endl;
-	}
-
-	m_v += m_delta_v + m_z;
-
-	m_metric_time.solve = (float)timer.getDuration<Timer::Seconds>().count();
-	timer.reset();
-
-	// Compute constraint forces
-	if (m_constraints3.empty()) {
-		m_constraint_forces.setZero();
-	}
-	else {
-		m_constraint_forces = m_dfdx_system * m_delta_v - m_rhs;
-	}
-
-	// Assign new positions to the nodes
-#pragma omp parallel for
-	for (int32_t i = 0; i < m_nodes.size(); ++i) {
-		m_nodes[i].x() += dt * m_v[3 * i + 0];
-		m_nodes[i].y() += dt * m_v[3 * i + 1];
-		m_nodes[i].z() += dt * m_v[3 * i + 2];
-	}
-
-	// Set position alteration
-	for (SVec::InnerIterator it(m_position_alteration); it;)
-	{
-		const uint32_t node_idx = (uint32_t)it.index() / 3;
-		// There must be values for the x y z
-		m_nodes[node_idx].x() += it.value(); ++it;
-		m_nodes[node_idx].y() += it.value(); ++it;
-		m_nodes[node_idx].z() += it.value(); ++it;
-	}
-
-	m_metric_time.step = (float)step_timer.getDuration<Timer::Seconds>().count();
-}
-
-void ParallelFEM::update_objects(TetMesh* mesh,
-	uint32_t from_sim_idx, uint32_t to_sim_idx,
-	bool add_position_alteration)
-{
-	assert(mesh != nullptr);
-
-	SVec::InnerIterator it_dx(m_position_alteration);
-	if (add_position_alteration && from_sim_idx > 0) {
-		while (it_dx && it_dx.index() < (size_t)from_sim_idx) {
-			++it_dx;
-		}
-	}
-
-	for (uint32_t i = from_sim_idx; i < to_sim_idx; ++i) {
-		Eigen::Vector3f pos = m_nodes[i].cast<float>();
-		if (add_position_alteration && it_dx && it_dx.index() == 3 * i) {
-			pos.x() += (float)it_dx.value(); ++it_dx;
-			pos.y() += (float)it_dx.value(); ++it_dx;
-			pos.z() += (float)it_dx.value(); ++it_dx;
-		}
-		mesh->update_node((int32_t)(i - from_sim_idx), pos);
-	}
-}
-
-void ParallelFEM::add_constraint(uint32_t node, const glm::vec3& v, 
-	const glm::vec3& dir, Float friction)
-{
-	std::map<uint32_t, Constraint>::iterator it = m_constraints3.find(node);
-
-	if (it != m_constraints3.end()) {
-		m_constraints3.erase(it);
-	}
-
-	m_z(3 * node + 0) = v.x - m_v[3 * node + 0];
-	m_z(3 * node + 1) = v.y - m_v[3 * node + 1];
-	m_z(3 * node + 2) = v.z - m_v[3 * node + 2];
-
-	const Vec3 d(dir.x, dir.y, dir.z);
-
-	m_constraints3.emplace(node,
-		Constraint{
-			d,
-			Mat3::Identity() - (d * d.transpose()),
-			friction
-		}
-	);
-}
-
-void ParallelFEM::add_constraint(uint32_t node, const glm::vec3& v)
-{
-
-	std::map<uint32_t, Constraint>::iterator it = m_constraints3.find(node);
-
-	if (it != m_constraints3.end()) {
-		if (it->second.dir.isZero() || it->second.dir.dot(cast_vec3(v)) < Float(0.0)) {
-			return;
-		}
-		else {
-			m_constraints3.erase(it);
-		}
-	}
-
-	m_z(3 * node + 0) = v.x - m_v[3 * node + 0];
-	m_z(3 * node + 1) = v.y - m_v[3 * node + 1];
-	m_z(3 * node + 2) = v.z - m_v[3 * node + 2];
-
-	m_constraints3.emplace(node,
-		Constraint{
-			Vec3::Zero(),
-			Mat3::Zero()
-		}
-	);
-}
-
-void ParallelFEM::erase_constraint(uint32_t node)
-{
-	m_constraints3.erase(node);
-}
-
-void ParallelFEM::add_position_alteration(uint32_t node, const glm::vec3& dx)
-{
-	m_position_alteration.coeffRef(3 * node + 0) = dx.x;
-	m_position_alteration.coeffRef(3 * node + 1) = dx.y;
-	m_position_alteration.coeffRef(3 * node + 2) = dx.z;
-}
-
-void ParallelFEM::clear_frame_alterations()
-{
-	m_z.setZero();
-	m_position_alteration.setZero();
-}
-const Vec3& ParallelFEM::get_node(uint32_t node) const
-{
-	return m_nodes[node];
-}
-
-Vec3 ParallelFEM::get_velocity(uint32_t node) const
-{
-	return m_v.segment<3>(3 * node);
-}
-
-Vec3 ParallelFEM::get_force_constraint(uint32_t node) const
-{
-	assert(m_constraints3.count(node));
-	return m_constraint_forces.segment<3>(node * 3);
-}
-
-Float ParallelFEM::compute_volume() const
-{
-	Float vol = Float(0);
-	for (size_t i = 0; i < m_elements.size(); ++i) {
-		const Mat3 Ds = compute_Ds(m_elements[i], m_nodes);
-		vol += std::abs(Ds.determinant()) / Float(6.0);
-	}
-
-	return vol;
-}
-
-
-void ParallelFEM::build_sparse_system()
-{
-	m_sparse_cache.clear();
-	m_sparse_cache.reserve(m_elements.size() * 4 * 4);
-	m_dfdx_system.setZero();
-
-	// Add all nodes with connectivity
-	for (size_t e = 0; e < m_elements.size(); ++e) {
-		const Vec4i& element = m_elements[e];
-
-		// Assign the force gradient to the system
-		for (uint32_t i = 0; i < 4; ++i) {
-			const uint32_t node_i = element[i];
-			// diagonal
-			m_sparse_cache.emplace(std::make_pair(node_i, node_i), SMatPtrs());
-			// off-diagonal
-			for (uint32_t j = i + 1; j < 4; ++j) {
-				const uint32_t node_j = element[j];
-				m_sparse_cache.emplace(std::make_pair(node_i, node_j), SMatPtrs());
-				m_sparse_cache.emplace(std::make_pair(node_j, node_i), SMatPtrs());
-			}
-		}
-	}
-
-	typedef Eigen::Triplet<Float> Triplet;
-	std::vector<Triplet> triplets;
-	triplets.reserve(m_sparse_cache.size() * 9);
-
-	for (const auto& it : m_sparse_cache) {
-		const uint32_t base_i = it.first.first * 3;
-		const uint32_t base_j = it.first.second * 3;
-		for (uint32_t i = 0; i < 3; ++i) {
-			for (uint32_t j = 0; j < 3; ++j) {
-				triplets.emplace_back(Triplet(base_i + i, base_j + j, Float(0)));
-			}
-		}
-	}
-
-	m_dfdx_system.setFromTriplets(triplets.begin(), triplets.end());
-
-	// Store start of each of the xyz components of the columns into m_sparse_cache
-	for (auto& it : m_sparse_cache) {
-		const uint32_t base_i = it.first.first * 3;
-		const uint32_t base_j = it.first.second * 3;
-		for (uint32_t j = 0; j < 3; ++j) {
-			it.second[j] = &m_dfdx_system.coeffRef(base_i, base_j + j);
-		}
-	}
-
-}
-
+﻿#include "ParallelFEM.hpp"
+
+#undef NDEBUG
+#include <assert.h>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <imgui.h>
+#include <omp.h>
+#include <glm/gtc/constants.hpp>
+
+#include "utils/Timer.hpp"
+#include "ElementBatch.hpp"
+#include "EnergyDensity.hpp"
+#include "Reordering.hpp"
+
+namespace sim {
+
+ParallelFEM::ParallelFEM(NodeOrdering node_ordering, ElementOrdering element_ordering)
+	: m_node_ordering(node_ordering), m_element_ordering(element_ordering)
+{
+}
+
+void ParallelFEM::initialize(const std::vector<const TetMesh*>& meshes)
+{
+	m_converged = true;
+
+	uint32_t num_elements = 0;
+	uint32_t num_nodes = 0;
+	std::vector<uint32_t> offsets;
+	offsets.reserve(meshes.size());
+	for (const TetMesh* mesh : meshes) {
+		assert(mesh != nullptr);
+		offsets.push_back(num_nodes);
+		num_elements += (uint32_t)mesh->elements().size();
+		num_nodes += (uint32_t)mesh->nodes().size();
+	}
+
+	// Load elements
+	std::vector<Vec4i> elements;
+	std::vector<Vec3> nodes;
+	elements.reserve(num_elements);
+	nodes.reserve(num_nodes);
+	for (size_t mesh_idx = 0; mesh_idx < meshes.size(); ++mesh_idx) {
+		const TetMesh* mesh = meshes[mesh_idx];
+		assert(mesh != nullptr);
+
+		for (const Eigen::Vector3f& p : mesh->nodes()) {
+			nodes.push_back(p.cast<Float>());
+		}
+
+		for (size_t e = 0; e < mesh->elements().size(); ++e) {
+			Vec4i element = mesh->elements()[e];
+			element[0] += offsets[mesh_idx];
+			element[1] += offsets[mesh_idx];
+			element[2] += offsets[mesh_idx];
+			element[3] += offsets[mesh_idx];
+			elements.push_back(element);
+		}
+	}
+
+	this->reorder_nodes(&nodes, &elements);
+	this->reorder_elements(nodes, &elements);
+	this->build_element_coloring(num_nodes, elements);
+
+	m_nodes.resize(num_nodes);
+	for (uint32_t n = 0; n < num_nodes; ++n) {
+		m_nodes.set_position(n, nodes[n]);
+	}
+
+	// Precompute volumes and matrix to build the deformation gradient
+	m_elements.resize(elements.size());
+	for (uint32_t i = 0; i < (uint32_t)elements.size(); ++i) {
+		const Mat3 Ds = compute_Ds(elements[i], nodes);
+		m_elements.set(i, elements[i], Ds.inverse(), std::abs(Ds.determinant()) / Float(6.0));
+	}
+	m_elements.fill_padding();
+
+	m_delta_v.resize(3 * m_nodes.size());
+	m_delta_v.setZero();
+	m_rhs.resize(3 * m_nodes.size());
+	m_Sc.resize(3 * m_nodes.size());
+	m_constraint_slots.assign(m_nodes.size(), NO_CONSTRAINT);
+	m_z.resize(3 * m_nodes.size()); m_z.setZero();
+	m_position_alteration.resize(3 * m_nodes.size());
+	m_constraint_forces.resize(3 * m_nodes.size());
+
+	m_tmp.resize(3 * m_nodes.size());
+
+	// The sparse matrix is built on the first step, with the storage of the parameters
+	build_node_elements(elements, num_nodes, &m_node_element_offsets, &m_node_elements);
+
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+	m_cg_solver.resize(3 * m_nodes.size());
+	m_mpcg_solver.resize(3 * m_nodes.size());
+	m_reduced_index.clear();
+#endif
+}
+
+
+template<bool Atomic, typename T>
+void ParallelFEM::assign_sparse_block(const Eigen::Block<const T, 3, 3>& m, uint32_t block) {
+
+	Float* values = m_dfdx_system.values() + 9 * (size_t)block;
+	for (uint32_t s = 0; s < 3; ++s) {
+		for (uint32_t t = 0; t < 3; ++t) {
+			if constexpr (Atomic) {
+#pragma omp atomic
+				values[3 * s + t] += m(t, s);
+			}
+			else {
+				values[3 * s + t] += m(t, s);
+			}
+		}
+	}
+}
+
+template<EnergyFunction Function, ParallelFEM::ElementWrite Write>
+void ParallelFEM::add_element_contribution(uint32_t i, Float dt, const Parameters& cfg, Vec* forces)
+{
+	EnergyDensity energy;
+	const Mat3 DmInv = m_elements.rest_DmInv(i);
+	const Mat3 F = compute_Ds(m_elements.element(i), m_nodes) * DmInv;
+	// Compute the energy function
+	energy.compute<Function>(F, cfg.mu(), cfg.lambda());
+
+	// Compute force derivative df/dx = -vol * ddPhi/ddx = -vol * ( dF/dx * ddPhi/ddF * dF/dx )
+	// and force f = -vol * dPhi/dx
+	Mat12 dfdx;
+	Vec12 f;
+	compute_element_forces(DmInv, m_elements.volume[i], energy.hessian(), energy.pk1(), &dfdx, &f);
+
+	this->scatter_element<Write>(i, dfdx, f, dt, forces);
+}
+
+template<EnergyFunction Function, ParallelFEM::ElementWrite Write>
+void ParallelFEM::add_element_batch_contribution(uint32_t first, uint32_t count,
+	Float dt, const Parameters& cfg, Vec* forces)
+{
+	assert(count > 0 && count <= ELEMENT_BATCH_SIZE);
+	typedef Eigen::Map<const FloatBatch, Eigen::Unaligned> BatchMap;
+
+	// The rest data is loaded directly from the store. The lanes after count hold the next
+	// elements or the padding, and their results are discarded
+	ElementBatch batch;
+	for (uint32_t k = 0; k < 9; ++k) {
+		batch.DmInv[k] = BatchMap(m_elements.DmInv[k].data() + first);
+	}
+	batch.volume = BatchMap(m_elements.volume.data() + first);
+
+	std::array<uint32_t, ELEMENT_BATCH_SIZE> elements;
+	for (uint32_t l = 0; l < ELEMENT_BATCH_SIZE; ++l) {
+		elements[l] = first + l;
+	}
+	this->compute_element_batch_contribution<Function, Write>(elements, count, dt, cfg, &batch, forces);
+}
+
+template<EnergyFunction Function, ParallelFEM::ElementWrite Write>
+void ParallelFEM::add_element_batch_contribution(const uint32_t* element_indices, uint32_t count,
+	Float dt, const Parameters& cfg, Vec* forces)
+{
+	assert(count > 0 && count <= ELEMENT_BATCH_SIZE);
+
+	// The rest data is gathered lane by lane. The lanes after count repeat the last element,
+	// and their results are discarded
+	std::array<uint32_t, ELEMENT_BATCH_SIZE> elements;
+	ElementBatch batch;
+	for (uint32_t l = 0; l < ELEMENT_BATCH_SIZE; ++l) {
+		const uint32_t e = element_indices[std::min(l, count - 1)];
+		elements[l] = e;
+		for (uint32_t k = 0; k < 9; ++k) {
+			batch.DmInv[k][l] = m_elements.DmInv[k][e];
+		}
+		batch.volume[l] = m_elements.volume[e];
+	}
+	this->compute_element_batch_contribution<Function, Write>(elements, count, dt, cfg, &batch, forces);
+}
+
+template<EnergyFunction Function, ParallelFEM::ElementWrite Write>
+void ParallelFEM::compute_element_batch_contribution(const std::array<uint32_t, ELEMENT_BATCH_SIZE>& elements,
+	uint32_t count, Float dt, const Parameters& cfg, ElementBatch* batch, Vec* forces)
+{
+	for (uint32_t a = 0; a < 4; ++a) {
+		const int32_t* nodes = m_elements.nodes[a].data();
+		for (uint32_t i = 0; i < 3; ++i) {
+			const Float* x = m_nodes.x[i].data();
+			for (uint32_t l = 0; l < ELEMENT_BATCH_SIZE; ++l) {
+				batch->x[3 * a + i][l] = x[nodes[elements[l]]];
+			}
+		}
+	}
+
+	std::array<Mat12, ELEMENT_BATCH_SIZE> dfdx;
+	std::array<Vec12, ELEMENT_BATCH_SIZE> f;
+	compute_element_batch<Function>(*batch, cfg.mu(), cfg.lambda(), dfdx.data(), f.data());
+
+	for (uint32_t l = 0; l < count; ++l) {
+		this->scatter_element<Write>(elements[l], dfdx[l], f[l], dt, forces);
+	}
+}
+
+namespace {
+
+// Index of the block (j, k), with j <= k, in the upper block triangle of a 12x12 element matrix
+constexpr uint32_t element_block_index(uint32_t j, uint32_t k)
+{
+	return 4 * j - j * (j - 1) / 2 + (k - j);
+}
+
+} // namespace
+
+template<ParallelFEM::ElementWrite Write>
+void ParallelFEM::scatter_element(uint32_t i, const Mat12& dfdx, const Vec12& f, Float dt, Vec* forces)
+{
+	if constexpr (Write == ElementWrite::Buffer) {
+		std::array<Mat3, 10>& out = m_element_dfdx[i];
+		for (uint32_t j = 0; j < 4; ++j) {
+			for (uint32_t k = j; k < 4; ++k) {
+				out[element_block_index(j, k)] = dfdx.block<3, 3>(3 * j, 3 * k);
+			}
+		}
+		m_element_forces[i] = dt * f;
+		return;
+	}
+
+	const Vec4i element = m_elements.element(i);
+
+	// Assign the force gradient to the system
+	const std::array<uint32_t, 16>& blocks = m_element_blocks[i];
+	for (uint32_t j = 0; j < 4; ++j) {
+		const uint32_t node_j = element[j];
+		// add forces to rhs
+		forces->segment<3>(3 * node_j) += dt * f.segment<3>(3 * j);
+
+		for (uint32_t k = 0; k < 4; ++k) {
+			if (blocks[4 * j + k] != NO_BLOCK) {
+				assign_sparse_block<Write == ElementWrite::Atomic>(dfdx.block<3, 3>(3 * j, 3 * k), blocks[4 * j + k]);
+			}
+		}
+	}
+}
+
+void ParallelFEM::gather_elements()
+{
+	// The blocks of the row of a node are only written by the thread that owns the node
+#pragma omp parallel for schedule(static)
+	for (int32_t n = 0; n < (int32_t)m_nodes.size(); ++n) {
+		Vec3 f = Vec3::Zero();
+		for (uint32_t k = m_node_element_offsets[n]; k < m_node_element_offsets[n + 1]; ++k) {
+			const uint32_t e = m_node_elements[k] / 4;
+			const uint32_t a = m_node_elements[k] % 4;
+			f += m_element_forces[e].segment<3>(3 * a);
+
+			const std::array<Mat3, 10>& dfdx = m_element_dfdx[e];
+			const std::array<uint32_t, 16>& blocks = m_element_blocks[e];
+			for (uint32_t b = 0; b < 4; ++b) {
+				const uint32_t block = blocks[4 * a + b];
+				if (block == NO_BLOCK) {
+					continue;
+				}
+				if (a <= b) {
+					m_dfdx_system.block(block) += dfdx[element_block_index(a, b)];
+				}
+				else {
+					m_dfdx_system.block(block) += dfdx[element_block_index(b, a)].transpose();
+				}
+			}
+		}
+		m_rhs.segment<3>(3 * n) += f;
+	}
+}
+
+template<EnergyFunction Function>
+void ParallelFEM::assemble_elements(Float dt, const Parameters& cfg)
+{
+	const bool batched = cfg.element_kernel() == ElementKernel::Batched;
+	constexpr int32_t batch_size = (int32_t)ELEMENT_BATCH_SIZE;
+	m_metric_time.gather = 0.0f;
+
+	AssemblyMode mode = cfg.assembly_mode();
+	// The atomic additions of the blocks happen in any order, so they are not deterministic
+	if (mode == AssemblyMode::Atomic && cfg.deterministic()) {
+		mode = AssemblyMode::Colored;
+	}
+
+	if (mode == AssemblyMode::Colored) {
+		// Elements of the same color do not share nodes, so they can be added without atomics.
+		// The result does not depend on the number of threads.
+#pragma omp parallel
+		for (size_t c = 0; c + 1 < m_color_offsets.size(); ++c) {
+			const int32_t begin = (int32_t)m_color_offsets[c];
+			const int32_t end = (int32_t)m_color_offsets[c + 1];
+			if (batched) {
+#pragma omp for
+				for (int32_t i = begin; i < end; i += batch_size) {
+					this->add_element_batch_contribution<Function, ElementWrite::Direct>(m_colored_elements.data() + i,
+						(uint32_t)std::min(batch_size, end - i), dt, cfg, &m_rhs);
+				}
+			}
+			else {
+#pragma omp for
+				for (int32_t i = begin; i < end; ++i) {
+					this->add_element_contribution<Function, ElementWrite::Direct>(m_colored_elements[i], dt, cfg, &m_rhs);
+				}
+			}
+		}
+		return;
+	}
+
+	if (mode == AssemblyMode::Gather) {
+		// Compute all the elements, and then gather their results by node
+		if (m_element_dfdx.size() != m_elements.size()) {
+			m_element_dfdx.resize(m_elements.size());
+			m_element_forces.resize(m_elements.size());
+		}
+		if (batched) {
+			const int32_t end = (int32_t)m_elements.size();
+#pragma omp parallel for
+			for (int32_t i = 0; i < end; i += batch_size) {
+				this->add_element_batch_contribution<Function, ElementWrite::Buffer>((uint32_t)i,
+					(uint32_t)std::min(batch_size, end - i), dt, cfg, nullptr);
+			}
+		}
+		else {
+#pragma omp parallel for
+			for (int32_t i = 0; i < (int32_t)m_elements.size(); ++i) {
+				this->add_element_contribution<Function, ElementWrite::Buffer>((uint32_t)i, dt, cfg, nullptr);
+			}
+		}
+
+		Timer timer;
+		this->gather_elements();
+		m_metric_time.gather = (float)timer.getDuration<Timer::Seconds>().count();
+		return;
+	}
+
+	// Each thread accumulates the forces of its elements, with a static schedule
+	// so that each thread always gets the same elements
+	if (m_thread_forces.size() < (size_t)omp_get_max_threads()) {
+		m_thread_forces.resize((size_t)omp_get_max_threads());
+	}
+	int32_t num_threads = 1;
+#pragma omp parallel
+	{
+#pragma omp single
+		num_threads = omp_get_num_threads();
+
+		Vec& forces = m_thread_forces[omp_get_thread_num()];
+		forces.setZero(m_rhs.size());
+
+		if (batched) {
+			const int32_t end = (int32_t)m_elements.size();
+#pragma omp for schedule(static)
+			for (int32_t i = 0; i < end; i += batch_size) {
+				this->add_element_batch_contribution<Function, ElementWrite::Atomic>((uint32_t)i,
+					(uint32_t)std::min(batch_size, end - i), dt, cfg, &forces);
+			}
+		}
+		else {
+#pragma omp for schedule(static)
+			for (int32_t i = 0; i < (int32_t)m_elements.size(); ++i) {
+				this->add_element_contribution<Function, ElementWrite::Atomic>((uint32_t)i, dt, cfg, &forces);
+			}
+		}
+	}
+
+	// Reduce the forces of the threads in order
+#pragma omp parallel for schedule(static)
+	for (int32_t i = 0; i < (int32_t)m_rhs.size(); ++i) {
+		Float sum = m_rhs(i);
+		for (int32_t t = 0; t < num_threads; ++t) {
+			sum += m_thread_forces[t](i);
+		}
+		m_rhs(i) = sum;
+	}
+}
+
+void ParallelFEM::step(Float dt, const Parameters& cfg)
+{
+	Timer step_timer;
+	Timer timer;
+
+	// Build the system the first time, or when the storage changes
+	const bool upper_only = cfg.matrix_storage() == MatrixStorage::SymmetricUpper;
+	if (m_dfdx_system.empty() || m_dfdx_system.upper_only() != upper_only) {
+		this->build_sparse_system(upper_only);
+	}
+
+	// Reset system
+	m_dfdx_system.set_zero();
+	m_rhs.setZero();
+
+	m_metric_time.set_zero = (float)timer.getDuration<Timer::Seconds>().count();
+	timer.reset();
+
+	// We are building the system
+	// 	   [M - Δt * df/dv - Δt^2 * df/dx] * Δv = Δt * f + Δt^2 * df/dx * v + Δt * df/dx * y
+	// The last bit Δt * df/dx * y comes from the forced position alteration Δx=Δt(v0+Δv)+y
+
+	// Add contribution of each element
+	switch (cfg.energy_function()) {
+	case EnergyFunction::HookeanSmith19:
+		this->assemble_elements<EnergyFunction::HookeanSmith19>(dt, cfg);
+		break;
+	case EnergyFunction::Corrotational:
+		this->assemble_elements<EnergyFunction::Corrotational>(dt, cfg);
+		break;
+	case EnergyFunction::HookeanSmith19Eigen:
+		this->assemble_elements<EnergyFunction::HookeanSmith19Eigen>(dt, cfg);
+		break;
+	case EnergyFunction::HookeanBW08:
+		this->assemble_elements<EnergyFunction::HookeanBW08>(dt, cfg);
+		break;
+	}
+
+	m_metric_time.blocks_assign = (float)timer.getDuration<Timer::Seconds>().count();
+	timer.reset();
+
+	// Apply rayleigh damping df/dv = -alpha * M - beta * df/dx
+	// Optimized:	M - Δt^2 * df/dx - Δt * df/dv 
+	//				M - Δt^2 * df/dx - Δt * (-alpha * M - beta * df/dx)
+	//				M * (1 - Δt * alpha) - * df/dx (Δt^2 + Δt * beta)
+	m_dt = dt;
+	m_stiffness_scale = -(dt * dt) - cfg.beta_rayleigh() * dt;
+	m_mass_diagonal = cfg.mass() * (Float(1.0) - cfg.alpha_rayleigh() * dt);
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+	// The direct solver needs the filtered system assembled
+	const bool direct = cfg.linear_solver() == LinearSolver::SparseCholesky;
+	const bool modified_pcg = !direct && cfg.constraint_filter() == ConstraintFilter::ModifiedPCG;
+	const bool reduced = !modified_pcg && cfg.eliminate_fixed_nodes();
+	if (reduced) {
+		this->update_reduced_system();
+	}
+#else
+	const bool modified_pcg = false;
+	const bool reduced = false;
+#endif
+	this->finish_system(cfg, modified_pcg ? SystemOutput::None :
+		reduced ? SystemOutput::Reduced : SystemOutput::Full);
+
+	m_metric_time.system_finish = (float)timer.getDuration<Timer::Seconds>().count();
+	// The constraints are applied in the same pass
+	m_metric_time.constraints = 0.0f;
+	timer.reset();
+
+#if (PARALLEL_FEM_SOLVER == CG_EIGEN)
+	m_system.to_sparse(&m_eigen_system);
+	m_cg_solver.compute(m_eigen_system);
+	m_cg_solver.setTolerance(1e-4);
+
+	if (m_cg_solver.info() != Eigen::Success) {
+		std::cerr << "Can't build system" << std::endl;
+		m_converged = false;
+	}
+	else {
+		m_delta_v = m_cg_solver.solveWithGuess(m_Sc, m_delta_v);
+		m_converged = m_cg_solver.info() == Eigen::Success;
+		// Eigen reports the residual relative to the right hand side
+		m_solver_stats.iterations = (uint32_t)m_cg_solver.iterations();
+		m_solver_stats.residual = m_cg_solver.error();
+		m_solver_stats.tolerance = m_cg_solver.tolerance();
+		m_solver_stats.stop = m_converged ? SolverStop::Converged : SolverStop::IterationLimit;
+	}
+#elif (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+
+	m_cg_solver.set_preconditioner(cfg.preconditioner());
+	m_mpcg_solver.set_preconditioner(cfg.preconditioner());
+	m_reduced_cg_solver.set_preconditioner(cfg.preconditioner());
+	m_cg_solver.set_initial_guess(cfg.initial_guess());
+	m_mpcg_solver.set_initial_guess(cfg.initial_guess());
+	m_reduced_cg_solver.set_initial_guess(cfg.initial_guess());
+	m_cg_solver.set_variant(cfg.cg_variant());
+	m_cg_solver.set_stopping_policy(cfg.stopping_policy());
+	m_reduced_cg_solver.set_variant(cfg.cg_variant());
+	m_mpcg_solver.set_stopping_policy(cfg.stopping_policy());
+	m_reduced_cg_solver.set_stopping_policy(cfg.stopping_policy());
+
+	if (modified_pcg) {
+		m_converged = m_mpcg_solver.solve(UnfilteredSystem(this), ConstraintProjection(this), m_Sc, &m_delta_v);
+		m_solver_stats = m_mpcg_solver.stats();
+	}
+	else if (reduced) {
+		// The solution of the fixed nodes is zero
+#pragma omp parallel for
+		for (int32_t r = 0; r < (int32_t)m_free_nodes.size(); ++r) {
+			m_reduced_rhs.segment<3>(3 * r) = m_Sc.segment<3>(3 * m_free_nodes[r]);
+			m_reduced_delta_v.segment<3>(3 * r) = m_delta_v.segment<3>(3 * m_free_nodes[r]);
+		}
+		if (direct && this->solve_direct(m_reduced_system, m_reduced_rhs, &m_reduced_delta_v)) {
+			m_converged = true;
+		}
+		else {
+			m_converged = m_reduced_cg_solver.solve(m_reduced_system, m_reduced_rhs, &m_reduced_delta_v);
+			m_solver_stats = m_reduced_cg_solver.stats();
+		}
+		m_delta_v.setZero();
+#pragma omp parallel for
+		for (int32_t r = 0; r < (int32_t)m_free_nodes.size(); ++r) {
+			m_delta_v.segment<3>(3 * m_free_nodes[r]) = m_reduced_delta_v.segment<3>(3 * r);
+		}
+	}
+	else if (direct && this->solve_direct(m_system, m_Sc, &m_delta_v)) {
+		m_converged = true;
+	}
+	else {
+		m_converged = m_cg_solver.solve(m_system, m_Sc, &m_delta_v);
+		m_solver_stats = m_cg_solver.stats();
+	}
+#endif
+
+	if (!m_converged) {
+		std::cerr << "System did not converge" << std::endl;
+	}
+
+	m_metric_time.solve = (float)timer.getDuration<Timer::Seconds>().count();
+	timer.reset();
+
+	// Compute constraint forces
+	if (m_constraints.empty()) {
+		m_constraint_forces.setZero();
+	}
+	else {
+		this->multiply_unfiltered_system(m_delta_v, &m_constraint_forces);
+		m_constraint_forces -= m_rhs;
+	}
+
+	// Assign new velocities and positions to the nodes
+	{
+		const Float* delta_v = m_delta_v.data();
+		const Float* z = m_z.data();
+		for (uint32_t c = 0; c < 3; ++c) {
+			Float* x = m_nodes.x[c].data();
+			Float* v = m_nodes.v[c].data();
+#pragma omp parallel for simd
+			for (int32_t i = 0; i < (int32_t)m_nodes.size(); ++i) {
+				v[i] += delta_v[3 * i + c] + z[3 * i + c];
+				x[i] += dt * v[i];
+			}
+		}
+	}
+
+	// Set position alteration
+	for (SVec::InnerIterator it(m_position_alteration); it;)
+	{
+		const uint32_t node_idx = (uint32_t)it.index() / 3;
+		// There must be values for the x y z
+		m_nodes.x[0][node_idx] += it.value(); ++it;
+		m_nodes.x[1][node_idx] += it.value(); ++it;
+		m_nodes.x[2][node_idx] += it.value(); ++it;
+	}
+
+	m_metric_time.step = (float)step_timer.getDuration<Timer::Seconds>().count();
+}
+
+void ParallelFEM::finish_system(const Parameters& cfg, SystemOutput output)
+{
+	const Float dt = m_dt;
+	// Δt * v + y, where y is the position alteration
+	const Float* v[3] = { m_nodes.v[0].data(), m_nodes.v[1].data(), m_nodes.v[2].data() };
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)m_nodes.size(); ++i) {
+		m_tmp(3 * i + 0) = dt * v[0][i];
+		m_tmp(3 * i + 1) = dt * v[1][i];
+		m_tmp(3 * i + 2) = dt * v[2][i];
+	}
+	m_tmp += m_position_alteration;
+
+
+	// A single pass over the blocks of df/dx, by block rows. For the block row i:
+	//		rhs_i += Δt * (df/dx * (Δt * v + y))_i - gravity - friction forces
+	//		A_ij = (Δt^2 + Δt * beta) * -df/dx_ij + (mass and friction damping if i == j)
+	//		m_system_ij = (S A S^T + I - S)_ij, or the block of m_reduced_system if both nodes are free
+	//		m_Sc_i = (S * (rhs - A * z))_i
+	// df/dx is only read, so that the transposed blocks of the upper storage can be read by any thread.
+	const BlockSparseMatrix& dfdx = m_dfdx_system;
+	const bool upper_only = dfdx.upper_only();
+#pragma omp parallel for
+	for (int32_t row = 0; row < (int32_t)dfdx.block_rows(); ++row) {
+		const uint32_t i = (uint32_t)row;
+		const Constraint* c_row = this->find_constraint(i);
+
+		Vec3 dfdx_y = Vec3::Zero();
+		Vec3 dfdx_z = Vec3::Zero();
+		for (uint32_t b = dfdx.row_begin(i); b < dfdx.row_end(i); ++b) {
+			const uint32_t j = dfdx.block_column(b);
+			const BlockSparseMatrix::ConstBlockRef K = dfdx.block(b);
+			dfdx_y.noalias() += K * m_tmp.segment<3>(3 * j);
+			dfdx_z.noalias() += K * m_z.segment<3>(3 * j);
+			uint32_t out = b;
+			if (output == SystemOutput::None) {
+				continue;
+			}
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+			if (output == SystemOutput::Reduced) {
+				out = m_reduced_blocks[b];
+				if (out == NO_BLOCK) {
+					continue;
+				}
+			}
+#endif
+
+			Mat3 A = m_stiffness_scale * K;
+			if (i == j) {
+				A += this->diagonal_damping(c_row);
+			}
+
+			const Constraint* c_col = this->find_constraint(j);
+			if (c_row != nullptr) {
+				A = c_row->constraint * A;
+			}
+			if (c_col != nullptr) {
+				A = A * c_col->constraint;
+			}
+			if (i == j && c_row != nullptr) {
+				A += Mat3::Identity() - c_row->constraint;
+			}
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+			if (output == SystemOutput::Reduced) {
+				m_reduced_system.block(out) = A;
+				continue;
+			}
+#endif
+			m_system.block(out) = A;
+		}
+		if (upper_only) {
+			for (uint32_t t = dfdx.transpose_begin(i); t < dfdx.transpose_end(i); ++t) {
+				const uint32_t j = dfdx.transpose_row(t);
+				const BlockSparseMatrix::ConstBlockRef K = dfdx.block(dfdx.transpose_block(t));
+				dfdx_y.noalias() += K.transpose() * m_tmp.segment<3>(3 * j);
+				dfdx_z.noalias() += K.transpose() * m_z.segment<3>(3 * j);
+			}
+		}
+
+		Vec3 rhs = m_rhs.segment<3>(3 * i) + dt * dfdx_y;
+		// subtract gravity from the y entries
+		rhs.y() -= dt * cfg.mass() * cfg.gravity();
+		// Add tangential friction forces f = -k * v
+		if (c_row != nullptr && c_row->friction != Float(0)) {
+			rhs -= dt * c_row->friction * m_nodes.velocity(i);
+		}
+		m_rhs.segment<3>(3 * i) = rhs;
+
+		// Pre-filtered Preconditioned Conjugate Gradient
+		// (SAS^T + I - S)y = Sc
+		//                y = x - z
+		//                c = b - Az
+		const Vec3 Az = m_stiffness_scale * dfdx_z + this->diagonal_damping(c_row) * m_z.segment<3>(3 * i);
+		m_Sc.segment<3>(3 * i) = c_row != nullptr ? Vec3(c_row->constraint * (rhs - Az)) : Vec3(rhs - Az);
+	}
+}
+
+Mat3 ParallelFEM::diagonal_damping(const Constraint* constraint) const
+{
+	Mat3 D = m_mass_diagonal * Mat3::Identity();
+	// Tangential friction damping as df/dv= -k * (I - n · n^T)
+	if (constraint != nullptr && constraint->friction != Float(0)) {
+		D += m_dt * constraint->friction * constraint->constraint;
+	}
+	return D;
+}
+
+void ParallelFEM::multiply_unfiltered_system(const Vec& x, Vec* y) const
+{
+	m_dfdx_system.multiply(x, y);
+	*y *= m_stiffness_scale;
+	y->noalias() += m_mass_diagonal * x;
+	for (const Constraint& c : m_constraints) {
+		if (c.friction != Float(0)) {
+			y->segment<3>(3 * c.node) += (m_dt * c.friction * c.constraint) * x.segment<3>(3 * c.node);
+		}
+	}
+}
+
+void ParallelFEM::UnfilteredSystem::diagonal(Vec* d) const
+{
+	m_fem->m_dfdx_system.diagonal(d);
+	*d *= m_fem->m_stiffness_scale;
+	d->array() += m_fem->m_mass_diagonal;
+	for (const Constraint& c : m_fem->m_constraints) {
+		if (c.friction != Float(0)) {
+			d->segment<3>(3 * c.node) += m_fem->m_dt * c.friction * c.constraint.diagonal();
+		}
+	}
+}
+
+void ParallelFEM::UnfilteredSystem::diagonal_blocks(std::vector<Mat3>* blocks) const
+{
+	const BlockSparseMatrix& dfdx = m_fem->m_dfdx_system;
+	blocks->resize(dfdx.block_rows());
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)dfdx.block_rows(); ++i) {
+		(*blocks)[i] = m_fem->m_stiffness_scale * dfdx.diagonal_block(i);
+		(*blocks)[i].diagonal().array() += m_fem->m_mass_diagonal;
+	}
+	for (const Constraint& c : m_fem->m_constraints) {
+		if (c.friction != Float(0)) {
+			(*blocks)[c.node] += m_fem->m_dt * c.friction * c.constraint;
+		}
+	}
+}
+
+void ParallelFEM::ConstraintProjection::apply(Vec* x) const
+{
+	for (const Constraint& c : m_fem->m_constraints) {
+		x->segment<3>(3 * c.node) = c.constraint * x->segment<3>(3 * c.node);
+	}
+}
+
+void ParallelFEM::update_objects(TetMesh* mesh,
+	uint32_t from_sim_idx, uint32_t to_sim_idx,
+	bool add_position_alteration)
+{
+	assert(mesh != nullptr);
+
+	// The indices of the mesh are the original ones, so the alterations are looked up by node
+	add_position_alteration = add_position_alteration && m_position_alteration.nonZeros() > 0;
+	for (uint32_t i = from_sim_idx; i < to_sim_idx; ++i) {
+		const uint32_t node = m_node_index[i];
+		Eigen::Vector3f pos = m_nodes.position(node).cast<float>();
+		if (add_position_alteration) {
+			pos.x() += (float)m_position_alteration.coeff(3 * node + 0);
+			pos.y() += (float)m_position_alteration.coeff(3 * node + 1);
+			pos.z() += (float)m_position_alteration.coeff(3 * node + 2);
+		}
+		mesh->update_node((int32_t)(i - from_sim_idx), pos);
+	}
+}
+
+void ParallelFEM::add_constraint(uint32_t node, const glm::vec3& v, 
+	const glm::vec3& dir, Float friction)
+{
+	node = m_node_index[node];
+
+	m_z.segment<3>(3 * node) = cast_vec3(v) - m_nodes.velocity(node);
+
+	const Vec3 d(dir.x, dir.y, dir.z);
+
+	this->set_constraint(
+		Constraint{
+			node,
+			d,
+			Mat3::Identity() - (d * d.transpose()),
+			friction
+		}
+	);
+}
+
+void ParallelFEM::add_constraint(uint32_t node, const glm::vec3& v)
+{
+	node = m_node_index[node];
+
+	const Constraint* c = this->find_constraint(node);
+	if (c != nullptr && (c->dir.isZero() || c->dir.dot(cast_vec3(v)) < Float(0.0))) {
+		return;
+	}
+
+	m_z.segment<3>(3 * node) = cast_vec3(v) - m_nodes.velocity(node);
+
+	this->set_constraint(
+		Constraint{
+			node,
+			Vec3::Zero(),
+			Mat3::Zero(),
+			Float(0),
+			true
+		}
+	);
+}
+
+void ParallelFEM::erase_constraint(uint32_t node)
+{
+	this->remove_constraint(m_node_index[node]);
+}
+
+void ParallelFEM::set_constraint(const Constraint& constraint)
+{
+	uint32_t& slot = m_constraint_slots[constraint.node];
+	if (slot == NO_CONSTRAINT) {
+		slot = (uint32_t)m_constraints.size();
+		m_constraints.push_back(constraint);
+	}
+	else {
+		m_constraints[slot] = constraint;
+	}
+}
+
+void ParallelFEM::remove_constraint(uint32_t node)
+{
+	const uint32_t slot = m_constraint_slots[node];
+	if (slot == NO_CONSTRAINT) {
+		return;
+	}
+
+	m_constraints[slot] = m_constraints.back();
+	m_constraint_slots[m_constraints[slot].node] = slot;
+	m_constraints.pop_back();
+	m_constraint_slots[node] = NO_CONSTRAINT;
+}
+
+void ParallelFEM::add_position_alteration(uint32_t node, const glm::vec3& dx)
+{
+	node = m_node_index[node];
+	m_position_alteration.coeffRef(3 * node + 0) = dx.x;
+	m_position_alteration.coeffRef(3 * node + 1) = dx.y;
+	m_position_alteration.coeffRef(3 * node + 2) = dx.z;
+}
+
+void ParallelFEM::clear_frame_alterations()
+{
+	m_z.setZero();
+	m_position_alteration.setZero();
+}
+Vec3 ParallelFEM::get_node(uint32_t node) const
+{
+	return m_nodes.position(m_node_index[node]);
+}
+
+Vec3 ParallelFEM::get_velocity(uint32_t node) const
+{
+	return m_nodes.velocity(m_node_index[node]);
+}
+
+Vec3 ParallelFEM::get_force_constraint(uint32_t node) const
+{
+	node = m_node_index[node];
+	assert(this->find_constraint(node) != nullptr);
+	return m_constraint_forces.segment<3>(node * 3);
+}
+
+Float ParallelFEM::compute_volume() const
+{
+	Float vol = Float(0);
+	for (uint32_t i = 0; i < (uint32_t)m_elements.size(); ++i) {
+		const Mat3 Ds = compute_Ds(m_elements.element(i), m_nodes);
+		vol += std::abs(Ds.determinant()) / Float(6.0);
+	}
+
+	return vol;
+}
+
+
+void ParallelFEM::build_sparse_system(bool upper_only)
+{
+	// Find the nodes that determine each node
+	std::vector<std::vector<uint32_t>> neighbours(m_nodes.size());
+	for (uint32_t e = 0; e < (uint32_t)m_elements.size(); ++e) {
+		const Vec4i element = m_elements.element(e);
+		for (uint32_t i = 0; i < 4; ++i) {
+			for (uint32_t j = 0; j < 4; ++j) {
+				neighbours[element[j]].push_back(element[i]);
+			}
+		}
+	}
+
+	for (std::vector<uint32_t>& n : neighbours) {
+		std::sort(n.begin(), n.end());
+		n.erase(std::unique(n.begin(), n.end()), n.end());
+	}
+
+	m_dfdx_system.set_pattern(neighbours, upper_only);
+	// Shares the pattern, the values are overwritten by finish_system
+	m_system = m_dfdx_system;
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+	m_reduced_index.clear();
+#endif
+
+	m_element_blocks.resize(m_elements.size());
+	for (uint32_t e = 0; e < (uint32_t)m_elements.size(); ++e) {
+		const Vec4i element = m_elements.element(e);
+		for (uint32_t j = 0; j < 4; ++j) {
+			for (uint32_t k = 0; k < 4; ++k) {
+				m_element_blocks[e][4 * j + k] = upper_only && element[j] > element[k] ?
+					NO_BLOCK : m_dfdx_system.block_index(element[j], element[k]);
+			}
+		}
+	}
+}
+
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+void ParallelFEM::update_reduced_system()
+{
+	const uint32_t num_nodes = (uint32_t)m_nodes.size();
+	bool changed = m_reduced_index.size() != num_nodes;
+	for (uint32_t n = 0; n < num_nodes && !changed; ++n) {
+		const Constraint* c = this->find_constraint(n);
+		changed = (c != nullptr && c->fixed) != (m_reduced_index[n] == NO_NODE);
+	}
+	if (!changed) {
+		return;
+	}
+
+	m_reduced_index.assign(num_nodes, NO_NODE);
+	m_free_nodes.clear();
+	for (uint32_t n = 0; n < num_nodes; ++n) {
+		const Constraint* c = this->find_constraint(n);
+		if (c == nullptr || !c->fixed) {
+			m_reduced_index[n] = (uint32_t)m_free_nodes.size();
+			m_free_nodes.push_back(n);
+		}
+	}
+
+	// The reduced indices keep the order of the nodes, so the upper blocks stay upper
+	const bool upper_only = m_dfdx_system.upper_only();
+	std::vector<std::vector<uint32_t>> row_columns(m_free_nodes.size());
+	for (uint32_t i = 0; i < num_nodes; ++i) {
+		const uint32_t ri = m_reduced_index[i];
+		if (ri == NO_NODE) {
+			continue;
+		}
+		for (uint32_t b = m_dfdx_system.row_begin(i); b < m_dfdx_system.row_end(i); ++b) {
+			const uint32_t rj = m_reduced_index[m_dfdx_system.block_column(b)];
+			if (rj == NO_NODE) {
+				continue;
+			}
+			row_columns[ri].push_back(rj);
+			if (upper_only && ri != rj) {
+				row_columns[rj].push_back(ri);
+			}
+		}
+	}
+	for (std::vector<uint32_t>& columns : row_columns) {
+		std::sort(columns.begin(), columns.end());
+	}
+	m_reduced_system.set_pattern(row_columns, upper_only);
+
+	m_reduced_blocks.assign(m_dfdx_system.num_blocks(), NO_BLOCK);
+	for (uint32_t i = 0; i < num_nodes; ++i) {
+		const uint32_t ri = m_reduced_index[i];
+		if (ri == NO_NODE) {
+			continue;
+		}
+		for (uint32_t b = m_dfdx_system.row_begin(i); b < m_dfdx_system.row_end(i); ++b) {
+			const uint32_t rj = m_reduced_index[m_dfdx_system.block_column(b)];
+			if (rj != NO_NODE) {
+				m_reduced_blocks[b] = m_reduced_system.block_index(ri, rj);
+			}
+		}
+	}
+
+	m_reduced_rhs.resize(3 * (Eigen::Index)m_free_nodes.size());
+	m_reduced_delta_v.setZero(3 * (Eigen::Index)m_free_nodes.size());
+	m_reduced_cg_solver.resize(3 * m_free_nodes.size());
+}
+
+bool ParallelFEM::solve_direct(const BlockSparseMatrix& A, const Vec& b, Vec* x)
+{
+	if (!m_direct_solver.compute(A)) {
+		std::cerr << "Can't factorize system, solving it with the conjugate gradient" << std::endl;
+		return false;
+	}
+	m_direct_solver.solve(b, x);
+
+	// The residual only measures the round off of the factorization
+	A.multiply(*x, &m_direct_residual);
+	m_direct_residual -= b;
+	m_solver_stats.iterations = 0;
+	m_solver_stats.residual = m_direct_residual.norm();
+	m_solver_stats.tolerance = Float(0);
+	m_solver_stats.stop = SolverStop::Converged;
+	return true;
+}
+#endif
+
+void ParallelFEM::reorder_nodes(std::vector<Vec3>* nodes, std::vector<Vec4i>* elements)
+{
+	const uint32_t num_nodes = (uint32_t)nodes->size();
+
+	// order[i] is the original index of the internal node i
+	std::vector<uint32_t> order;
+	switch (m_node_ordering) {
+	case NodeOrdering::ReverseCuthillMcKee:
+		order = reverse_cuthill_mckee_order(*elements, num_nodes);
+		break;
+	case NodeOrdering::Morton:
+		order = morton_order(*nodes);
+		break;
+	default:
+		break;
+	}
+
+	m_node_index.resize(num_nodes);
+	if (order.empty()) {
+		std::iota(m_node_index.begin(), m_node_index.end(), 0);
+		return;
+	}
+
+	assert(order.size() == num_nodes);
+	std::vector<Vec3> reordered(num_nodes);
+	for (uint32_t i = 0; i < num_nodes; ++i) {
+		m_node_index[order[i]] = i;
+		reordered[i] = (*nodes)[order[i]];
+	}
+	*nodes = std::move(reordered);
+
+	for (Vec4i& element : *elements) {
+		for (uint32_t a = 0; a < 4; ++a) {
+			element[a] = (int)m_node_index[element[a]];
+		}
+	}
+}
+
+void ParallelFEM::reorder_elements(const std::vector<Vec3>& nodes, std::vector<Vec4i>* elements) const
+{
+	if (m_element_ordering != ElementOrdering::Morton) {
+		return;
+	}
+
+	std::vector<Vec3> centroids(elements->size());
+	for (size_t e = 0; e < elements->size(); ++e) {
+		const Vec4i& element = (*elements)[e];
+		centroids[e] = Float(0.25) * (nodes[element[0]] + nodes[element[1]] +
+			nodes[element[2]] + nodes[element[3]]);
+	}
+
+	const std::vector<uint32_t> order = morton_order(centroids);
+	std::vector<Vec4i> sorted(elements->size());
+	for (size_t e = 0; e < elements->size(); ++e) {
+		sorted[e] = (*elements)[order[e]];
+	}
+	*elements = std::move(sorted);
+}
+
+void ParallelFEM::build_element_coloring(uint32_t num_nodes, const std::vector<Vec4i>& elements)
+{
+	// Greedy coloring, each element takes the first color not used by its neighbours
+	std::vector<uint32_t> colors(elements.size());
+	// Colors of the elements already colored that contain each node
+	std::vector<std::vector<uint32_t>> node_colors(num_nodes);
+	// forbidden[c] == e if the color c is used by some neighbour of e
+	std::vector<uint32_t> forbidden;
+	for (uint32_t e = 0; e < (uint32_t)elements.size(); ++e) {
+		const Vec4i& element = elements[e];
+		for (uint32_t j = 0; j < 4; ++j) {
+			for (const uint32_t c : node_colors[element[j]]) {
+				forbidden[c] = e;
+			}
+		}
+
+		uint32_t c = 0;
+		while (c < forbidden.size() && forbidden[c] == e) {
+			++c;
+		}
+		if (c == forbidden.size()) {
+			forbidden.push_back(std::numeric_limits<uint32_t>::max());
+		}
+		colors[e] = c;
+		for (uint32_t j = 0; j < 4; ++j) {
+			node_colors[element[j]].push_back(c);
+		}
+	}
+
+	// Sort the element indices by color, keeping the order of the store inside each color
+	m_color_offsets.assign(forbidden.size() + 1, 0);
+	for (uint32_t c : colors) {
+		m_color_offsets[c + 1] += 1;
+	}
+	for (size_t c = 0; c < forbidden.size(); ++c) {
+		m_color_offsets[c + 1] += m_color_offsets[c];
+	}
+	m_colored_elements.resize(elements.size());
+	std::vector<uint32_t> cursor(m_color_offsets.begin(), m_color_offsets.end() - 1);
+	for (uint32_t e = 0; e < (uint32_t)elements.size(); ++e) {
+		m_colored_elements[cursor[colors[e]]++] = e;
+	}
+}
+
 } // namespace sim
\ No newline at end of file
@@ -1,114 +1,272 @@
-#pragma once
-
-#include "IFEM.hpp"
-
-#include <Eigen/Sparse>
-#include <Eigen/Dense>
-
-#include <array>
-#include <memory>
-
-#include "GameObject.hpp"
-#include "meshes/TetMesh.hpp"
-#include "solvers/ConjugateGradient.hpp"
-
-namespace sim {
-
-class ParallelFEM final : public IFEM {
-public:
-
-	ParallelFEM();
-
-	void initialize(const std::vector<const TetMesh*>& meshes) override final;
-
-	void step(Float dt, const Parameters& params) override final;
-
-	void update_objects(TetMesh* mesh,
-		uint32_t from_sim_idx, uint32_t to_sim_idx,
-		bool add_position_alteration) override final;
-
-	void add_constraint(uint32_t node, const glm::vec3& v,
-		const glm::vec3& dir, Float friction) override final;
-
-	void add_constraint(uint32_t node, const glm::vec3& v) override final;
-
-	void erase_constraint(uint32_t node) override final;
-
-	void add_position_alteration(uint32_t node, const glm::vec3& dx) override final;
-
-	void clear_frame_alterations() override final;
-
-	const Vec3& get_node(uint32_t node) const override final;
-	Vec3 get_velocity(uint32_t node) const override final;
-	Vec3 get_force_constraint(uint32_t node) const override final;
-
-	Float compute_volume() const override final;
-
-private:
-#define CG_EIGEN 0
-#define CG_CUSTOM 1
-#define PARALLEL_FEM_SOLVER CG_CUSTOM
-
-	Vec m_delta_v;
-	Vec m_v;
-	Vec m_rhs;
-	SMat m_dfdx_system;
-	SMat m_system;
-	struct Constraint;
-	std::map<uint32_t, Constraint> m_constraints3;
-	Vec m_Sc;
-	Vec m_constraint_forces;
-	Vec m_z;
-	SVec m_position_alteration;
-
-	Vec m_tmp;
-
-	std::vector<Mat3> m_DmInvs;
-
-	std::vector<Float> m_volumes;
-
-
-	std::vector<Eigen::Vector4i> m_elements;
-	std::vector<Vec3> m_nodes;
-
-#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
-	ConjugateGradient m_cg_solver;
-#elif (PARALLEL_FEM_SOLVER == CG_EIGEN)
-	Eigen::ConjugateGradient<SMat> m_cg_solver;
-#else
-	static_assert(false, "Wrong value of PARALLEL_FEM_SOLVER");
-#endif
-
-	struct hash_pair {
-		template <class T1, class T2>
-		size_t operator()(const std::pair<T1, T2>& p) const
-		{
-			auto hash1 = std::hash<T1>{}(p.first);
-			auto hash2 = std::hash<T2>{}(p.second);
-			return hash1 ^ (hash2 << 1);
-		}
-	};
-
-	struct Constraint {
-		Vec3 dir;
-		Mat3 constraint;
-		Float friction = Float(0);
-	};
-
-	// sparse_cache has pointers to the 3x3 region of the sparse matrix where node i
-	// determines node j. In particular, it stores the 3 pointers to the first elements
-	// of the 3 columns of the 3x3 region.
-	typedef std::array<Float*, 3> SMatPtrs;
-	std::unordered_map<std::pair<uint32_t, uint32_t>, SMatPtrs, hash_pair> m_sparse_cache;
-
-
-	void build_sparse_system();
-
-	template<typename T>
-	void assign_sparse_block(const Eigen::Block<const T, 3, 3>& m, uint32_t i, uint32_t j);
-
-	void set_system_to_zero();
-
-};
-
+#pragma once
+
+#include "IFEM.hpp"
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <array>
+#include <memory>
+#include <limits>
+
+#include "GameObject.hpp"
+#include "meshes/TetMesh.hpp"
+#include "solvers/ConjugateGradient.hpp"
+#include "solvers/ModifiedConjugateGradient.hpp"
+#include "solvers/SparseCholesky.hpp"
+#include "BlockSparseMatrix.hpp"
+#include "SoAStore.hpp"
+#include "ElementBatch.hpp"
+
+namespace sim {
+
+class ParallelFEM final : public IFEM {
+public:
+
+	ParallelFEM(NodeOrdering node_ordering = NodeOrdering::Original,
+		ElementOrdering element_ordering = ElementOrdering::Original);
+
+	void initialize(const std::vector<const TetMesh*>& meshes) override final;
+
+	void step(Float dt, const Parameters& params) override final;
+
+	void update_objects(TetMesh* mesh,
+		uint32_t from_sim_idx, uint32_t to_sim_idx,
+		bool add_position_alteration) override final;
+
+	void add_constraint(uint32_t node, const glm::vec3& v,
+		const glm::vec3& dir, Float friction) override final;
+
+	void add_constraint(uint32_t node, const glm::vec3& v) override final;
+
+	void erase_constraint(uint32_t node) override final;
+
+	void add_position_alteration(uint32_t node, const glm::vec3& dx) override final;
+
+	void clear_frame_alterations() override final;
+
+	Vec3 get_node(uint32_t node) const override final;
+	Vec3 get_velocity(uint32_t node) const override final;
+	Vec3 get_force_constraint(uint32_t node) const override final;
+
+	Float compute_volume() const override final;
+
+private:
+#define CG_EIGEN 0
+#define CG_CUSTOM 1
+#define PARALLEL_FEM_SOLVER CG_CUSTOM
+
+	Vec m_delta_v;
+	Vec m_rhs;
+	// Assembled force derivative, and the filtered system A built from it
+	BlockSparseMatrix m_dfdx_system;
+	BlockSparseMatrix m_system;
+	// Coefficients of A = stiffness_scale * df/dx + mass_diagonal * I + Δt * friction
+	Float m_stiffness_scale = Float(0);
+	Float m_mass_diagonal = Float(0);
+	Float m_dt = Float(0);
+	struct Constraint;
+	// Compact list of the active constraints, in no particular order
+	std::vector<Constraint> m_constraints;
+	// Index in m_constraints of the constraint of each node, or NO_CONSTRAINT
+	std::vector<uint32_t> m_constraint_slots;
+	static constexpr uint32_t NO_CONSTRAINT = std::numeric_limits<uint32_t>::max();
+	Vec m_Sc;
+	Vec m_constraint_forces;
+	Vec m_z;
+	SVec m_position_alteration;
+
+	Vec m_tmp;
+
+	// Positions and velocities of the nodes
+	NodeStore m_nodes;
+	// Elements with their rest data, in the order of m_element_ordering
+	ElementStore m_elements;
+
+	// Internal index of each node, which differs from the original one if the nodes were reordered.
+	// The public interface always uses the original indices
+	NodeOrdering m_node_ordering;
+	std::vector<uint32_t> m_node_index;
+	// The per element arrays are computed after sorting the elements
+	ElementOrdering m_element_ordering;
+
+	// Element indices sorted by color, where no two elements of the same color share a node.
+	// The elements of color c are in the range [m_color_offsets[c], m_color_offsets[c + 1]).
+	// The store keeps its own order, so neighbouring elements stay close in memory
+	std::vector<uint32_t> m_colored_elements;
+	std::vector<uint32_t> m_color_offsets;
+
+	// Forces accumulated by each thread with atomic assembly, reduced into m_rhs afterwards
+	std::vector<Vec> m_thread_forces;
+
+	// Elements that contain each node, as 4 * element + local index of the node.
+	// The ones of node n are in the range [m_node_element_offsets[n], m_node_element_offsets[n + 1])
+	std::vector<uint32_t> m_node_element_offsets;
+	std::vector<uint32_t> m_node_elements;
+
+	// Results of each element for the gather assembly, the blocks (j, k) with j <= k of
+	// the element force derivative, and the element forces scaled by dt
+	std::vector<std::array<Mat3, 10>> m_element_dfdx;
+	std::vector<Vec12> m_element_forces;
+
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+	ConjugateGradient m_cg_solver;
+	ModifiedConjugateGradient m_mpcg_solver;
+
+	// Filtered system without the fixed nodes, the nodes whose constraint removes all their
+	// degrees of freedom. Its pattern is rebuilt when the set of fixed nodes changes
+	BlockSparseMatrix m_reduced_system;
+	// Reduced index of each node, or NO_NODE if it is fixed, and the node of each reduced index
+	std::vector<uint32_t> m_reduced_index;
+	std::vector<uint32_t> m_free_nodes;
+	// Block of m_reduced_system of each block of m_dfdx_system, or NO_BLOCK
+	std::vector<uint32_t> m_reduced_blocks;
+	Vec m_reduced_rhs;
+	Vec m_reduced_delta_v;
+	ConjugateGradient m_reduced_cg_solver;
+
+	// Direct solver of m_system or m_reduced_system, analyzed again when the solved pattern changes
+	SparseCholesky m_direct_solver;
+	Vec m_direct_residual;
+	static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+#elif (PARALLEL_FEM_SOLVER == CG_EIGEN)
+	Eigen::ConjugateGradient<SMat> m_cg_solver;
+	// Scalar copy of m_system, which the Eigen solver keeps a reference to
+	SMat m_eigen_system;
+#else
+	static_assert(false, "Wrong value of PARALLEL_FEM_SOLVER");
+#endif
+
+	struct Constraint {
+		uint32_t node;
+		Vec3 dir;
+		Mat3 constraint;
+		Float friction = Float(0);
+		// The constraint removes all the degrees of freedom of the node
+		bool fixed = false;
+	};
+
+	// Indices in m_dfdx_system of the 3x3 blocks of an element.
+	// Block 4 * j + k is the region where the node j of the element determines the node k.
+	// With half storage, the blocks below the diagonal are NO_BLOCK.
+	std::vector<std::array<uint32_t, 16>> m_element_blocks;
+	static constexpr uint32_t NO_BLOCK = std::numeric_limits<uint32_t>::max();
+
+	void build_sparse_system(bool upper_only);
+
+	// Where finish_system writes the filtered system
+	enum class SystemOutput {
+		// Not written, the system is applied through df/dx
+		None,
+		// m_system
+		Full,
+		// m_reduced_system
+		Reduced,
+	};
+
+	// Adds the rest of the terms to the rhs, and writes the filtered rhs and system
+	// in a single pass over the assembled df/dx, which is left unchanged
+	void finish_system(const Parameters& cfg, SystemOutput output);
+
+#if (PARALLEL_FEM_SOLVER == CG_CUSTOM)
+	// Rebuilds the pattern of m_reduced_system if the set of fixed nodes changed
+	void update_reduced_system();
+
+	// Solves A * x = b with m_direct_solver and sets the solver stats.
+	// Returns false if the factorization failed, and x is left unchanged
+	bool solve_direct(const BlockSparseMatrix& A, const Vec& b, Vec* x);
+#endif
+
+	// Constraint of a node, or nullptr if it is not constrained
+	const Constraint* find_constraint(uint32_t node) const {
+		const uint32_t slot = m_constraint_slots[node];
+		return slot != NO_CONSTRAINT ? &m_constraints[slot] : nullptr;
+	}
+
+	// Adds or replaces the constraint of constraint.node
+	void set_constraint(const Constraint& constraint);
+
+	// Removes the constraint of a node, moving the last constraint of the list to its slot
+	void remove_constraint(uint32_t node);
+
+	// Mass damping and friction damping of the diagonal block of a node, constraint can be nullptr
+	Mat3 diagonal_damping(const Constraint* constraint) const;
+
+	// y = A * x, with A the system before the constraint filter
+	void multiply_unfiltered_system(const Vec& x, Vec* y) const;
+
+	// The system before the constraint filter, for the modified conjugate gradient
+	class UnfilteredSystem final : public ConjugateGradient::LinearOperator {
+	public:
+		UnfilteredSystem(const ParallelFEM* fem) : m_fem(fem) {}
+		Eigen::Index rows() const override final { return m_fem->m_dfdx_system.rows(); }
+		void multiply(const Vec& x, Vec* y) const override final { m_fem->multiply_unfiltered_system(x, y); }
+		void diagonal(Vec* d) const override final;
+		void diagonal_blocks(std::vector<Mat3>* blocks) const override final;
+	private:
+		const ParallelFEM* m_fem;
+	};
+
+	// The constraint filter S, for the modified conjugate gradient
+	class ConstraintProjection final : public ModifiedConjugateGradient::Filter {
+	public:
+		ConstraintProjection(const ParallelFEM* fem) : m_fem(fem) {}
+		void apply(Vec* x) const override final;
+	private:
+		const ParallelFEM* m_fem;
+	};
+
+	void reorder_nodes(std::vector<Vec3>* nodes, std::vector<Vec4i>* elements);
+
+	void reorder_elements(const std::vector<Vec3>& nodes, std::vector<Vec4i>* elements) const;
+
+	// Colors the elements and sorts their indices by color
+	void build_element_coloring(uint32_t num_nodes, const std::vector<Vec4i>& elements);
+
+	// Element loop, instantiated for each energy function
+	template<EnergyFunction Function>
+	void assemble_elements(Float dt, const Parameters& cfg);
+
+	// How the results of an element are written
+	enum class ElementWrite {
+		// Added to the system without synchronization
+		Direct,
+		// Added to the system with atomics
+		Atomic,
+		// Stored in the element buffers, to be gathered by nodes
+		Buffer,
+	};
+
+	// The forces of the elements are added to forces, and the force derivatives to m_dfdx_system
+	template<EnergyFunction Function, ElementWrite Write>
+	void add_element_contribution(uint32_t element_idx, Float dt, const Parameters& cfg, Vec* forces);
+
+	// Adds the contribution of the elements [first, first + count), with count <= ELEMENT_BATCH_SIZE,
+	// using the batched kernel
+	template<EnergyFunction Function, ElementWrite Write>
+	void add_element_batch_contribution(uint32_t first, uint32_t count,
+		Float dt, const Parameters& cfg, Vec* forces);
+
+	// Same with the count elements of the list element_indices
+	template<EnergyFunction Function, ElementWrite Write>
+	void add_element_batch_contribution(const uint32_t* element_indices, uint32_t count,
+		Float dt, const Parameters& cfg, Vec* forces);
+
+	// Gathers the node positions of the elements of each lane into batch, and adds the
+	// contribution of the first count lanes
+	template<EnergyFunction Function, ElementWrite Write>
+	void compute_element_batch_contribution(const std::array<uint32_t, ELEMENT_BATCH_SIZE>& elements,
+		uint32_t count, Float dt, const Parameters& cfg, ElementBatch* batch, Vec* forces);
+
+	template<ElementWrite Write>
+	void scatter_element(uint32_t element_idx, const Mat12& dfdx, const Vec12& f, Float dt, Vec* forces);
+
+	// Adds the element buffers to the system, where each thread owns a range of block rows
+	void gather_elements();
+
+	template<bool Atomic, typename T>
+	void assign_sparse_block(const Eigen::Block<const T, 3, 3>& m, uint32_t block);
+
+};
+
 } // namespace sim
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "Reordering.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cassert>
+
+namespace sim {
+
+namespace {
+
+// Breadth first search from start that appends the visited nodes to order,
+// visiting the neighbours of each node by increasing degree.
+// Returns the index in order of the first node of the last level.
+size_t cuthill_mckee_bfs(uint32_t start,
+	const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& adjacency,
+	std::vector<bool>* visited, std::vector<uint32_t>* order, size_t* levels = nullptr)
+{
+	const auto degree = [&offsets](uint32_t n) { return offsets[n + 1] - offsets[n]; };
+
+	size_t level_begin = order->size();
+	size_t last_level_begin = level_begin;
+	size_t num_levels = 0;
+	(*visited)[start] = true;
+	order->push_back(start);
+	while (level_begin < order->size()) {
+		last_level_begin = level_begin;
+		++num_levels;
+		const size_t level_end = order->size();
+		for (size_t q = level_begin; q < level_end; ++q) {
+			const uint32_t n = (*order)[q];
+			const size_t first_new = order->size();
+			for (uint32_t k = offsets[n]; k < offsets[n + 1]; ++k) {
+				if (!(*visited)[adjacency[k]]) {
+					(*visited)[adjacency[k]] = true;
+					order->push_back(adjacency[k]);
+				}
+			}
+			std::stable_sort(order->begin() + first_new, order->end(),
+				[&degree](uint32_t a, uint32_t b) { return degree(a) < degree(b); });
+		}
+		level_begin = level_end;
+	}
+
+	if (levels) {
+		*levels = num_levels;
+	}
+	return last_level_begin;
+}
+
+// Spreads the lower 21 bits of v so that there are two zeros between each bit
+inline uint64_t spread_bits(uint64_t v)
+{
+	v &= 0x1fffff;
+	v = (v | (v << 32)) & 0x1f00000000ffffull;
+	v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+	v = (v | (v << 8)) & 0x100f00f00f00f00full;
+	v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+	v = (v | (v << 2)) & 0x1249249249249249ull;
+	return v;
+}
+
+} // namespace
+
+std::vector<uint32_t> reverse_cuthill_mckee_order(const std::vector<Vec4i>& elements, uint32_t num_nodes)
+{
+	// Adjacency of the nodes in CSR format
+	std::vector<std::vector<uint32_t>> neighbours(num_nodes);
+	for (const Vec4i& element : elements) {
+		for (uint32_t i = 0; i < 4; ++i) {
+			for (uint32_t j = 0; j < 4; ++j) {
+				if (i != j) {
+					neighbours[element[i]].push_back(element[j]);
+				}
+			}
+		}
+	}
+	std::vector<uint32_t> offsets(num_nodes + 1, 0);
+	for (uint32_t n = 0; n < num_nodes; ++n) {
+		std::vector<uint32_t>& v = neighbours[n];
+		std::sort(v.begin(), v.end());
+		v.erase(std::unique(v.begin(), v.end()), v.end());
+		offsets[n + 1] = offsets[n] + (uint32_t)v.size();
+	}
+	std::vector<uint32_t> adjacency;
+	adjacency.reserve(offsets.back());
+	for (std::vector<uint32_t>& v : neighbours) {
+		adjacency.insert(adjacency.end(), v.begin(), v.end());
+		std::vector<uint32_t>().swap(v);
+	}
+
+	// Start the search of each connected component from the nodes of lowest degree
+	std::vector<uint32_t> candidates(num_nodes);
+	std::iota(candidates.begin(), candidates.end(), 0);
+	std::stable_sort(candidates.begin(), candidates.end(), [&offsets](uint32_t a, uint32_t b) {
+		return offsets[a + 1] - offsets[a] < offsets[b + 1] - offsets[b];
+		});
+
+	std::vector<bool> visited(num_nodes, false);
+	std::vector<uint32_t> order;
+	order.reserve(num_nodes);
+	for (const uint32_t candidate : candidates) {
+		if (visited[candidate]) {
+			continue;
+		}
+
+		// Look for a pseudo-peripheral start node, the node of lowest degree of
+		// the last level of a search, while that increases the depth of the search
+		uint32_t start = candidate;
+		size_t depth = 0;
+		for (uint32_t it = 0; it < 4; ++it) {
+			std::vector<bool> tmp_visited = visited;
+			std::vector<uint32_t> tmp_order;
+			size_t levels = 0;
+			const size_t last_level = cuthill_mckee_bfs(start, offsets, adjacency, &tmp_visited, &tmp_order, &levels);
+			if (it > 0 && levels <= depth) {
+				break;
+			}
+			depth = levels;
+
+			uint32_t best = tmp_order[last_level];
+			for (size_t q = last_level; q < tmp_order.size(); ++q) {
+				if (offsets[tmp_order[q] + 1] - offsets[tmp_order[q]] < offsets[best + 1] - offsets[best]) {
+					best = tmp_order[q];
+				}
+			}
+			start = best;
+		}
+
+		cuthill_mckee_bfs(start, offsets, adjacency, &visited, &order);
+	}
+
+	std::reverse(order.begin(), order.end());
+	assert(order.size() == num_nodes);
+	return order;
+}
+
+void build_node_elements(const std::vector<Vec4i>& elements, uint32_t num_nodes,
+	std::vector<uint32_t>* offsets, std::vector<uint32_t>* node_elements)
+{
+	offsets->assign(num_nodes + 1, 0);
+	for (const Vec4i& element : elements) {
+		for (uint32_t j = 0; j < 4; ++j) {
+			(*offsets)[element[j] + 1] += 1;
+		}
+	}
+	for (uint32_t n = 0; n < num_nodes; ++n) {
+		(*offsets)[n + 1] += (*offsets)[n];
+	}
+
+	node_elements->resize(offsets->back());
+	std::vector<uint32_t> cursor(offsets->begin(), offsets->end() - 1);
+	for (uint32_t e = 0; e < (uint32_t)elements.size(); ++e) {
+		for (uint32_t j = 0; j < 4; ++j) {
+			(*node_elements)[cursor[elements[e][j]]++] = 4 * e + j;
+		}
+	}
+}
+
+std::vector<uint32_t> morton_order(const std::vector<Vec3>& points)
+{
+	std::vector<uint32_t> order(points.size());
+	std::iota(order.begin(), order.end(), 0);
+	if (points.empty()) {
+		return order;
+	}
+
+	Vec3 min = points[0];
+	Vec3 max = points[0];
+	for (const Vec3& p : points) {
+		min = min.cwiseMin(p);
+		max = max.cwiseMax(p);
+	}
+	const Float extent = std::max((max - min).maxCoeff(), std::numeric_limits<Float>::min());
+	const Float scale = Float((1u << 21) - 1) / extent;
+
+	std::vector<uint64_t> codes(points.size());
+	for (size_t i = 0; i < points.size(); ++i) {
+		const Vec3 q = (points[i] - min) * scale;
+		codes[i] = spread_bits((uint64_t)q.x()) |
+			(spread_bits((uint64_t)q.y()) << 1) |
+			(spread_bits((uint64_t)q.z()) << 2);
+	}
+
+	std::stable_sort(order.begin(), order.end(),
+		[&codes](uint32_t a, uint32_t b) { return codes[a] < codes[b]; });
+	return order;
+}
+
+} // namespace sim
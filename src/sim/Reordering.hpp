@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "IFEM.hpp"
+
+namespace sim {
+
+// Orders that improve the memory locality of the nodes and elements.
+// They return order, where order[i] is the old index of the value that goes to the position i.
+
+// Reverse Cuthill-McKee order of the nodes, which reduces the bandwidth of the system
+std::vector<uint32_t> reverse_cuthill_mckee_order(const std::vector<Vec4i>& elements, uint32_t num_nodes);
+
+// Elements that contain each node in CSR format, as 4 * element + local index of the node.
+// The ones of node n are in the range [(*offsets)[n], (*offsets)[n + 1]) of node_elements
+void build_node_elements(const std::vector<Vec4i>& elements, uint32_t num_nodes,
+	std::vector<uint32_t>* offsets, std::vector<uint32_t>* node_elements);
+
+// Order of the points along the Morton (Z-order) curve of their bounding box
+std::vector<uint32_t> morton_order(const std::vector<Vec3>& points);
+
+} // namespace sim
@@ -1,105 +1,98 @@
-#pragma once
-
-#include "IFEM.hpp"
-
-#include <Eigen/Sparse>
-#include <Eigen/Dense>
-
-#include <array>
-#include <memory>
-
-#include "GameObject.hpp"
-#include "meshes/TetMesh.hpp"
-#include "solvers/ConjugateGradient.hpp"
-
-
-
-namespace sim {
-
-class SimpleFem final : public IFEM {
-public:
-
-	SimpleFem();
-
-	void initialize(const std::vector<const TetMesh*>& meshes) override final;
-
-	void step(Float dt, const Parameters& params) override final;
-
-	void update_objects(TetMesh* mesh,
-		uint32_t from_sim_idx, uint32_t to_sim_idx, 
-		bool add_position_alteration) override final;
-	
-	void add_constraint(uint32_t node, const glm::vec3& v, const glm::vec3& dir, Float friction) override final;
-
-	void add_constraint(uint32_t node, const glm::vec3& v) override final;
-
-	void erase_constraint(uint32_t node) override final;
-
-	void add_position_alteration(uint32_t node, const glm::vec3& dx) override final;
-
-	void clear_frame_alterations() override final;
-
-	const Vec3& get_node(uint32_t node) const override final;
-	Vec3 get_velocity(uint32_t node) const override final;
-	Vec3 get_force_constraint(uint32_t node) const override final;
-
-	Float compute_volume() const override final;
-
-private:
-	Vec m_delta_v;
-	Vec m_v;
-	Vec m_rhs;
-	SMat m_dfdx_system;
-	SMat m_system;
-	struct Constraint;
-	std::map<uint32_t, Constraint> m_constraints3;
-	SMat m_S;
-	Vec m_Sc;
-	Vec m_constraint_forces;
-	Vec m_z;
-	SVec m_position_alteration;
-
-	Vec m_tmp;
-
-	std::vector<Mat3> m_DmInvs;
-
-	std::vector<Float> m_volumes;
-
-	std::vector<Eigen::Vector4i> m_elements;
-	std::vector<Vec3> m_nodes;
-
-	ConjugateGradient m_cg_solver;
-
-	struct hash_pair {
-		template <class T1, class T2>
-		size_t operator()(const std::pair<T1, T2>& p) const
-		{
-			auto hash1 = std::hash<T1>{}(p.first);
-			auto hash2 = std::hash<T2>{}(p.second);
-			return hash1 ^ hash2;
-		}
-	};
-
-	struct Constraint {
-		Vec3 dir;
-		Mat3 constraint;
-	};
-
-	// sparse_cache has pointers to the 3x3 region of the sparse matrix where node i
-	// determines node j. In particular, it stores the 3 pointers to the first elements
-	// of the 3 columns of the 3x3 region.
-	typedef std::array<Float*, 3> SMatPtrs;
-	std::unordered_map<std::pair<uint32_t, uint32_t>, SMatPtrs, hash_pair> m_sparse_cache;
-
-
-	
-
-	void build_sparse_system();
-
-	void assign_sparse_block(const Eigen::Block<const Mat12, 3, 3>& m, uint32_t i, uint32_t j);
-
-	void set_system_to_zero();
-
-};
-
+#pragma once
+
+#include "IFEM.hpp"
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <array>
+#include <memory>
+
+#include "GameObject.hpp"
+#include "meshes/TetMesh.hpp"
+#include "solvers/ConjugateGradient.hpp"
+
+
+
+namespace sim {
+
+class SimpleFem final : public IFEM {
+public:
+
+	SimpleFem();
+
+	void initialize(const std::vector<const TetMesh*>& meshes) override final;
+
+	void step(Float dt, const Parameters& params) override final;
+
+	void update_objects(TetMesh* mesh,
+		uint32_t from_sim_idx, uint32_t to_sim_idx, 
+		bool add_position_alteration) override final;
+	
+	void add_constraint(uint32_t node, const glm::vec3& v, const glm::vec3& dir, Float friction) override final;
+
+	void add_constraint(uint32_t node, const glm::vec3& v) override final;
+
+	void erase_constraint(uint32_t node) override final;
+
+	void add_position_alteration(uint32_t node, const glm::vec3& dx) override final;
+
+	void clear_frame_alterations() override final;
+
+	Vec3 get_node(uint32_t node) const override final;
+	Vec3 get_velocity(uint32_t node) const override final;
+	Vec3 get_force_constraint(uint32_t node) const override final;
+
+	Float compute_volume() const override final;
+
+private:
+	Vec m_delta_v;
+	Vec m_v;
+	Vec m_rhs;
+	SMat m_dfdx_system;
+	SMat m_system;
+	struct Constraint;
+	std::map<uint32_t, Constraint> m_constraints3;
+	SMat m_S;
+	Vec m_Sc;
+	Vec m_constraint_forces;
+	Vec m_z;
+	SVec m_position_alteration;
+
+	Vec m_tmp;
+
+	std::vector<Mat3> m_DmInvs;
+
+	std::vector<Float> m_volumes;
+
+	std::vector<Eigen::Vector4i> m_elements;
+	std::vector<Vec3> m_nodes;
+
+	ConjugateGradient m_cg_solver;
+
+	struct Constraint {
+		Vec3 dir;
+		Mat3 constraint;
+	};
+
+	// Offsets into the values of m_dfdx_system of the first value of each 3x3 block of an element.
+	// Block 4 * j + k is the region where the node j of the element determines the node k.
+	std::vector<std::array<uint32_t, 16>> m_element_blocks;
+	// Offset of the diagonal 3x3 block of each node
+	std::vector<uint32_t> m_diagonal_blocks;
+	// Distance between the 3 columns of the blocks that are in the columns of each node
+	std::vector<uint32_t> m_column_strides;
+
+	void build_sparse_system();
+
+	// Element loop, instantiated for each energy function
+	template<EnergyFunction Function>
+	void assemble_elements(Float dt, const Parameters& cfg);
+
+	void assign_sparse_block(const Eigen::Block<const Mat12, 3, 3>& m, uint32_t offset, uint32_t stride);
+
+	void set_system_to_zero();
+
+};
+
 } // namespace sim
\ No newline at end of file
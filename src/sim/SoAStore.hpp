@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Dense>
+
+#include "IFEM.hpp"
+#include "ElementBatch.hpp"
+
+namespace sim {
+
+// Arrays of the stores, aligned for SIMD loads
+template<typename T>
+using AlignedVector = std::vector<T, Eigen::aligned_allocator<T>>;
+
+// Number of values allocated for arrays of size values, so that a full SIMD batch
+// can be loaded starting at any valid index
+inline size_t simd_padded_size(size_t size)
+{
+	return (size + 2 * ELEMENT_BATCH_SIZE - 2) / ELEMENT_BATCH_SIZE * ELEMENT_BATCH_SIZE;
+}
+
+// Positions and velocities of the nodes in structure of arrays layout.
+// The padding values are zero.
+struct NodeStore {
+	// Coordinate i of the position of the node n is x[i][n]
+	std::array<AlignedVector<Float>, 3> x;
+	// Coordinate i of the velocity of the node n is v[i][n]
+	std::array<AlignedVector<Float>, 3> v;
+
+	size_t size() const { return m_size; }
+
+	void resize(size_t size)
+	{
+		m_size = size;
+		for (uint32_t i = 0; i < 3; ++i) {
+			x[i].assign(simd_padded_size(size), Float(0));
+			v[i].assign(simd_padded_size(size), Float(0));
+		}
+	}
+
+	Vec3 position(uint32_t n) const { return Vec3(x[0][n], x[1][n], x[2][n]); }
+	Vec3 velocity(uint32_t n) const { return Vec3(v[0][n], v[1][n], v[2][n]); }
+
+	void set_position(uint32_t n, const Vec3& p)
+	{
+		x[0][n] = p.x();
+		x[1][n] = p.y();
+		x[2][n] = p.z();
+	}
+
+private:
+	size_t m_size = 0;
+};
+
+// Connectivity and rest data of the elements in structure of arrays layout.
+// The padding repeats the last element, so batches never see degenerate elements.
+struct ElementStore {
+	// Node a of the element e is nodes[a][e]
+	std::array<AlignedVector<int32_t>, 4> nodes;
+	// Inverse of the rest shape matrix Dm, in column major order
+	std::array<AlignedVector<Float>, 9> DmInv;
+	AlignedVector<Float> volume;
+
+	size_t size() const { return m_size; }
+
+	void resize(size_t size)
+	{
+		m_size = size;
+		for (AlignedVector<int32_t>& a : nodes) {
+			a.resize(simd_padded_size(size));
+		}
+		for (AlignedVector<Float>& a : DmInv) {
+			a.resize(simd_padded_size(size));
+		}
+		volume.resize(simd_padded_size(size));
+	}
+
+	void set(uint32_t e, const Vec4i& element, const Mat3& element_DmInv, Float element_volume)
+	{
+		for (uint32_t a = 0; a < 4; ++a) {
+			nodes[a][e] = element[a];
+		}
+		for (uint32_t k = 0; k < 9; ++k) {
+			DmInv[k][e] = element_DmInv.data()[k];
+		}
+		volume[e] = element_volume;
+	}
+
+	// Fills the padding with copies of the last element
+	void fill_padding()
+	{
+		if (m_size == 0) {
+			return;
+		}
+		for (AlignedVector<int32_t>& a : nodes) {
+			std::fill(a.begin() + m_size, a.end(), a[m_size - 1]);
+		}
+		for (AlignedVector<Float>& a : DmInv) {
+			std::fill(a.begin() + m_size, a.end(), a[m_size - 1]);
+		}
+		std::fill(volume.begin() + m_size, volume.end(), volume[m_size - 1]);
+	}
+
+	Vec4i element(uint32_t e) const { return Vec4i(nodes[0][e], nodes[1][e], nodes[2][e], nodes[3][e]); }
+
+	Mat3 rest_DmInv(uint32_t e) const
+	{
+		Mat3 m;
+		for (uint32_t k = 0; k < 9; ++k) {
+			m.data()[k] = DmInv[k][e];
+		}
+		return m;
+	}
+
+private:
+	size_t m_size = 0;
+};
+
+inline Mat3 compute_Ds(const Vec4i& element, const NodeStore& nodes) {
+	const Vec3 x0 = nodes.position(element(0));
+	Mat3 Ds;
+	Ds.col(0) = nodes.position(element(1)) - x0;
+	Ds.col(1) = nodes.position(element(2)) - x0;
+	Ds.col(2) = nodes.position(element(3)) - x0;
+
+	return Ds;
+}
+
+} // namespace sim
@@ -0,0 +1,372 @@
+#include "AlgebraicMultigrid.hpp"
+
+#include "ConjugateGradient.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace sim {
+
+namespace {
+
+// Hierarchy limits
+constexpr uint32_t MAX_LEVELS = 10;
+constexpr uint32_t MAX_COARSEST_NODES = 64;
+
+// Calls f(j, A_ij) for all the blocks of the block row i, also the ones below the
+// diagonal that an upper storage keeps transposed
+template<typename F>
+inline void for_each_row_block(const BlockSparseMatrix& A, uint32_t i, F f)
+{
+	for (uint32_t b = A.row_begin(i); b < A.row_end(i); ++b) {
+		f(A.block_column(b), Mat3(A.block(b)));
+	}
+	if (A.upper_only()) {
+		for (uint32_t t = A.transpose_begin(i); t < A.transpose_end(i); ++t) {
+			f(A.transpose_row(t), Mat3(A.block(A.transpose_block(t)).transpose()));
+		}
+	}
+}
+
+// Same, only for the block columns
+template<typename F>
+inline void for_each_row_column(const BlockSparseMatrix& A, uint32_t i, F f)
+{
+	for (uint32_t b = A.row_begin(i); b < A.row_end(i); ++b) {
+		f(A.block_column(b));
+	}
+	if (A.upper_only()) {
+		for (uint32_t t = A.transpose_begin(i); t < A.transpose_end(i); ++t) {
+			f(A.transpose_row(t));
+		}
+	}
+}
+
+inline void sort_unique(std::vector<uint32_t>* v)
+{
+	std::sort(v->begin(), v->end());
+	v->erase(std::unique(v->begin(), v->end()), v->end());
+}
+
+// Index of the block of the column j in the row i, which must exist
+inline uint32_t find_block(const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& columns,
+	uint32_t i, uint32_t j)
+{
+	const auto begin = columns.begin() + offsets[i];
+	const auto end = columns.begin() + offsets[i + 1];
+	const auto it = std::lower_bound(begin, end, j);
+	assert(it != end && *it == j);
+	return (uint32_t)(it - columns.begin());
+}
+
+// Greedy aggregation of the graph of A: first the nodes whose neighbours are all free
+// start an aggregate with them, then the rest join the aggregate of a neighbour
+uint32_t aggregate(const BlockSparseMatrix& A, std::vector<uint32_t>* aggregates)
+{
+	constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	const uint32_t n = A.block_rows();
+	aggregates->assign(n, NONE);
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < n; ++i) {
+		bool free = true;
+		for_each_row_column(A, i, [&](uint32_t j) { free = free && (*aggregates)[j] == NONE; });
+		if (free) {
+			for_each_row_column(A, i, [&](uint32_t j) { (*aggregates)[j] = count; });
+			++count;
+		}
+	}
+
+	// The nodes that join a neighbour aggregate are not used to propagate it further
+	std::vector<uint32_t> joined(n, NONE);
+	for (uint32_t i = 0; i < n; ++i) {
+		if ((*aggregates)[i] != NONE) {
+			continue;
+		}
+		for_each_row_column(A, i, [&](uint32_t j) {
+			if (joined[i] == NONE && (*aggregates)[j] != NONE) {
+				joined[i] = (*aggregates)[j];
+			}
+			});
+	}
+	for (uint32_t i = 0; i < n; ++i) {
+		if (joined[i] != NONE) {
+			(*aggregates)[i] = joined[i];
+		}
+	}
+
+	// Isolated nodes left, with their free neighbours
+	for (uint32_t i = 0; i < n; ++i) {
+		if ((*aggregates)[i] == NONE) {
+			for_each_row_column(A, i, [&](uint32_t j) {
+				if ((*aggregates)[j] == NONE) {
+					(*aggregates)[j] = count;
+				}
+				});
+			++count;
+		}
+	}
+
+	return count;
+}
+
+} // namespace
+
+void AlgebraicMultigrid::compute(const BlockSparseMatrix& A)
+{
+	assert(!A.empty());
+	if (m_levels.empty() || !A.has_pattern(m_pattern)) {
+		this->analyze(A);
+	}
+
+	m_levels[0].A = &A;
+	for (uint32_t l = 0; l < (uint32_t)m_levels.size(); ++l) {
+		this->update_level(l);
+	}
+}
+
+void AlgebraicMultigrid::analyze(const BlockSparseMatrix& A)
+{
+	m_pattern = A.pattern_handle();
+	m_levels.clear();
+	m_levels.reserve(MAX_LEVELS);
+	m_levels.emplace_back();
+	m_levels[0].A = &A;
+
+	while (m_levels.size() < MAX_LEVELS) {
+		Level& level = m_levels.back();
+		const BlockSparseMatrix& fine = *level.A;
+		const uint32_t n = fine.block_rows();
+		if (n <= MAX_COARSEST_NODES) {
+			break;
+		}
+
+		level.num_aggregates = aggregate(fine, &level.aggregates);
+		if (level.num_aggregates == n) {
+			break;
+		}
+
+		// P row i has the aggregates of the neighbours of i, after smoothing the aggregation
+		BlockRows& P = level.P;
+		P.offsets.assign(n + 1, 0);
+		P.columns.clear();
+		std::vector<uint32_t> row;
+		for (uint32_t i = 0; i < n; ++i) {
+			row.clear();
+			for_each_row_column(fine, i, [&](uint32_t j) { row.push_back(level.aggregates[j]); });
+			sort_unique(&row);
+			P.columns.insert(P.columns.end(), row.begin(), row.end());
+			P.offsets[i + 1] = (uint32_t)P.columns.size();
+		}
+		P.blocks.resize(P.columns.size());
+
+		// Blocks of P by column
+		level.restriction_offsets.assign(level.num_aggregates + 1, 0);
+		for (const uint32_t a : P.columns) {
+			level.restriction_offsets[a + 1] += 1;
+		}
+		for (uint32_t a = 0; a < level.num_aggregates; ++a) {
+			level.restriction_offsets[a + 1] += level.restriction_offsets[a];
+		}
+		level.restriction_rows.resize(P.columns.size());
+		level.restriction_blocks.resize(P.columns.size());
+		std::vector<uint32_t> cursor(level.restriction_offsets.begin(), level.restriction_offsets.end() - 1);
+		for (uint32_t i = 0; i < n; ++i) {
+			for (uint32_t b = P.offsets[i]; b < P.offsets[i + 1]; ++b) {
+				const uint32_t t = cursor[P.columns[b]]++;
+				level.restriction_rows[t] = i;
+				level.restriction_blocks[t] = b;
+			}
+		}
+
+		// A * P
+		BlockRows& AP = level.AP;
+		AP.offsets.assign(n + 1, 0);
+		AP.columns.clear();
+		for (uint32_t i = 0; i < n; ++i) {
+			row.clear();
+			for_each_row_column(fine, i, [&](uint32_t j) {
+				row.insert(row.end(), P.columns.begin() + P.offsets[j], P.columns.begin() + P.offsets[j + 1]);
+				});
+			sort_unique(&row);
+			AP.columns.insert(AP.columns.end(), row.begin(), row.end());
+			AP.offsets[i + 1] = (uint32_t)AP.columns.size();
+		}
+		AP.blocks.resize(AP.columns.size());
+
+		// P^T * A * P
+		std::vector<std::vector<uint32_t>> row_columns(level.num_aggregates);
+		for (uint32_t a = 0; a < level.num_aggregates; ++a) {
+			for (uint32_t t = level.restriction_offsets[a]; t < level.restriction_offsets[a + 1]; ++t) {
+				const uint32_t i = level.restriction_rows[t];
+				row_columns[a].insert(row_columns[a].end(),
+					AP.columns.begin() + AP.offsets[i], AP.columns.begin() + AP.offsets[i + 1]);
+			}
+			sort_unique(&row_columns[a]);
+		}
+		level.coarse_A.set_pattern(row_columns);
+
+		const BlockSparseMatrix* coarse = &level.coarse_A;
+		m_levels.emplace_back();
+		m_levels.back().A = coarse;
+	}
+}
+
+void AlgebraicMultigrid::update_level(uint32_t l)
+{
+	Level& level = m_levels[l];
+	const BlockSparseMatrix& A = *level.A;
+	const uint32_t n = A.block_rows();
+	level.x.resize(A.rows());
+	level.b.resize(A.rows());
+	level.r.resize(A.rows());
+
+	// Coarsest level, solved directly
+	if (l + 1 == (uint32_t)m_levels.size()) {
+		Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic> dense(A.rows(), A.cols());
+		dense.setZero();
+		for (uint32_t i = 0; i < n; ++i) {
+			for_each_row_block(A, i, [&](uint32_t j, const Mat3& block) {
+				dense.block<3, 3>(3 * i, 3 * j) = block;
+				});
+		}
+		m_coarse_solver.compute(dense);
+		return;
+	}
+
+	// Jacobi with weight 4 / (3 * rho(D^-1 * A)), with the spectral radius bounded by the row sums.
+	// Until omega is known, the row i of P stores the sum of the blocks of A of each aggregate, (A * P0)_i
+	BlockRows& P = level.P;
+	level.inv_diagonal.resize(n);
+	Float rho = Float(0);
+#pragma omp parallel for reduction(max:rho)
+	for (int32_t i = 0; i < (int32_t)n; ++i) {
+		for (uint32_t b = P.offsets[i]; b < P.offsets[i + 1]; ++b) {
+			P.blocks[b].setZero();
+		}
+		level.inv_diagonal[i] = invert_diagonal_block(A.diagonal_block(i));
+		Vec3 row_sum = Vec3::Zero();
+		for_each_row_block(A, i, [&](uint32_t j, const Mat3& block) {
+			row_sum += (level.inv_diagonal[i] * block).cwiseAbs().rowwise().sum();
+			P.blocks[find_block(P.offsets, P.columns, i, level.aggregates[j])] += block;
+			});
+		rho = std::max(rho, row_sum.maxCoeff());
+	}
+	level.omega = Float(4) / (Float(3) * std::max(rho, Float(1)));
+
+	// P = (I - omega * D^-1 * A) * P0, with P0 the aggregation
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)n; ++i) {
+		const Mat3 scaled_inv = level.omega * level.inv_diagonal[i];
+		for (uint32_t b = P.offsets[i]; b < P.offsets[i + 1]; ++b) {
+			P.blocks[b] = -scaled_inv * P.blocks[b];
+			if (P.columns[b] == level.aggregates[i]) {
+				P.blocks[b] += Mat3::Identity();
+			}
+		}
+	}
+
+	// The products look up the blocks of the row being written by their coarse column
+	BlockRows& AP = level.AP;
+	BlockSparseMatrix& coarse = level.coarse_A;
+#pragma omp parallel
+	{
+		std::vector<uint32_t> row_blocks(level.num_aggregates);
+
+		// A * P
+#pragma omp for
+		for (int32_t i = 0; i < (int32_t)n; ++i) {
+			for (uint32_t b = AP.offsets[i]; b < AP.offsets[i + 1]; ++b) {
+				AP.blocks[b].setZero();
+				row_blocks[AP.columns[b]] = b;
+			}
+			for_each_row_block(A, i, [&](uint32_t j, const Mat3& block) {
+				for (uint32_t b = P.offsets[j]; b < P.offsets[j + 1]; ++b) {
+					AP.blocks[row_blocks[P.columns[b]]].noalias() += block * P.blocks[b];
+				}
+				});
+		}
+
+		// P^T * A * P, by coarse rows
+#pragma omp for
+		for (int32_t a = 0; a < (int32_t)level.num_aggregates; ++a) {
+			for (uint32_t b = coarse.row_begin(a); b < coarse.row_end(a); ++b) {
+				coarse.block(b).setZero();
+				row_blocks[coarse.block_column(b)] = b;
+			}
+			for (uint32_t t = level.restriction_offsets[a]; t < level.restriction_offsets[a + 1]; ++t) {
+				const uint32_t i = level.restriction_rows[t];
+				const Mat3 P_ia_T = P.blocks[level.restriction_blocks[t]].transpose();
+				for (uint32_t b = AP.offsets[i]; b < AP.offsets[i + 1]; ++b) {
+					coarse.block(row_blocks[AP.columns[b]]).noalias() += P_ia_T * AP.blocks[b];
+				}
+			}
+		}
+	}
+}
+
+void AlgebraicMultigrid::solve(const Vec& b, Vec* x) const
+{
+	assert(x != nullptr);
+	assert(!m_levels.empty());
+	m_levels[0].b = b;
+	this->v_cycle(0);
+	*x = m_levels[0].x;
+}
+
+void AlgebraicMultigrid::v_cycle(uint32_t l) const
+{
+	const Level& level = m_levels[l];
+	if (l + 1 == (uint32_t)m_levels.size()) {
+		level.x = m_coarse_solver.solve(level.b);
+		return;
+	}
+	const Level& coarse = m_levels[l + 1];
+
+	// Pre-smoothing, starting from zero
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)level.A->block_rows(); ++i) {
+		level.x.segment<3>(3 * i).noalias() = level.omega * (level.inv_diagonal[i] * level.b.segment<3>(3 * i));
+	}
+
+	// Restriction of the residual
+	level.A->multiply(level.x, &level.r);
+	level.r = level.b - level.r;
+#pragma omp parallel for
+	for (int32_t a = 0; a < (int32_t)level.num_aggregates; ++a) {
+		Vec3 sum = Vec3::Zero();
+		for (uint32_t t = level.restriction_offsets[a]; t < level.restriction_offsets[a + 1]; ++t) {
+			sum.noalias() += level.P.blocks[level.restriction_blocks[t]].transpose() *
+				level.r.segment<3>(3 * (Eigen::Index)level.restriction_rows[t]);
+		}
+		coarse.b.segment<3>(3 * a) = sum;
+	}
+
+	this->v_cycle(l + 1);
+
+	// Prolongation of the correction
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)level.A->block_rows(); ++i) {
+		Vec3 sum = Vec3::Zero();
+		for (uint32_t b = level.P.offsets[i]; b < level.P.offsets[i + 1]; ++b) {
+			sum.noalias() += level.P.blocks[b] * coarse.x.segment<3>(3 * (Eigen::Index)level.P.columns[b]);
+		}
+		level.x.segment<3>(3 * i) += sum;
+	}
+
+	// Post-smoothing, the same as the pre-smoothing so the cycle is symmetric
+	this->smooth(level);
+}
+
+void AlgebraicMultigrid::smooth(const Level& level) const
+{
+	level.A->multiply(level.x, &level.r);
+	level.r = level.b - level.r;
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)level.A->block_rows(); ++i) {
+		level.x.segment<3>(3 * i).noalias() += level.omega * (level.inv_diagonal[i] * level.r.segment<3>(3 * i));
+	}
+}
+
+} // namespace sim
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+#include "sim/IFEM.hpp"
+#include "sim/BlockSparseMatrix.hpp"
+
+namespace sim {
+
+// Smoothed aggregation algebraic multigrid over the 3x3 node blocks, applied as one V-cycle.
+// The aggregates and the patterns of the hierarchy only depend on the pattern of the system,
+// and are built again only if it changes. The values are recomputed by each compute().
+// The near null space are the three translations, so the coarse unknowns are also 3x3 blocks.
+class AlgebraicMultigrid {
+public:
+
+	AlgebraicMultigrid() = default;
+
+	// Builds the hierarchy for A, which must be symmetric and stay alive while it is used by solve()
+	void compute(const BlockSparseMatrix& A);
+
+	// x = M^-1 * b, with M^-1 the V-cycle
+	void solve(const Vec& b, Vec* x) const;
+
+	// Number of levels of the hierarchy, including the fine level
+	uint32_t num_levels() const { return (uint32_t)m_levels.size(); }
+
+private:
+
+	// Rectangular block matrix from the nodes of a level to the aggregates of the next one, by rows
+	struct BlockRows {
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> columns;
+		std::vector<Mat3> blocks;
+	};
+
+	struct Level {
+		// The system of the level, which is the input matrix for the first level
+		const BlockSparseMatrix* A = nullptr;
+		BlockSparseMatrix coarse_A;
+
+		// Inverse diagonal blocks and weight of the Jacobi smoother and of the prolongator smoothing
+		std::vector<Mat3> inv_diagonal;
+		Float omega = Float(0);
+
+		// Aggregate of each node
+		std::vector<uint32_t> aggregates;
+		uint32_t num_aggregates = 0;
+
+		// Smoothed prolongator P, and the blocks of P of each aggregate, as the fine node
+		// and the index of the block in P, in the range [restriction_offsets[a], restriction_offsets[a + 1])
+		BlockRows P;
+		std::vector<uint32_t> restriction_offsets;
+		std::vector<uint32_t> restriction_rows;
+		std::vector<uint32_t> restriction_blocks;
+
+		// A * P, computed to build the coarse system P^T * A * P
+		BlockRows AP;
+
+		// Buffers of the V-cycle
+		mutable Vec x;
+		mutable Vec b;
+		mutable Vec r;
+	};
+
+	std::vector<Level> m_levels;
+
+	// Dense factorization of the coarsest system
+	Eigen::LDLT<Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic>> m_coarse_solver;
+
+	// Pattern of the input matrix the hierarchy was built for
+	BlockSparseMatrix::PatternHandle m_pattern;
+
+	// Builds the aggregates and the patterns of all the levels
+	void analyze(const BlockSparseMatrix& A);
+
+	// Computes the values of the level l, and the coarse system of the next level
+	void update_level(uint32_t l);
+
+	void v_cycle(uint32_t l) const;
+
+	// x += omega * D^-1 * (b - A * x), where the residual is left in r
+	void smooth(const Level& level) const;
+
+}; // class AlgebraicMultigrid
+
+} // namespace sim
@@ -1,93 +1,414 @@
-#include "ConjugateGradient.hpp"
-
-namespace sim {
-
-ConjugateGradient::ConjugateGradient(size_t size)
-{
-	this->resize(size);
-}
-
-void ConjugateGradient::resize(size_t size)
-{
-	m_residual.resize((Eigen::Index)size);
-	m_dir.resize((Eigen::Index)size);
-	m_Adir.resize((Eigen::Index)size);
-	m_A_res_precond.resize((Eigen::Index)size);
-	m_jacobi_precond.resize((Eigen::Index)size);
-}
-
-bool ConjugateGradient::solve(const SMat& A, const Vec& b, Vec* x_)
-{
-	assert(x_ != nullptr);
-	Vec& x = *x_;
-	assert(A.rows() == m_residual.rows());
-	assert(A.cols() == m_residual.rows());
-	assert(b.rows() == m_residual.rows());
-	assert(x.rows() == m_residual.rows());
-	const Float max_error = Float(1e-4);
-	const uint32_t max_iterations = (uint32_t)m_residual.rows();
-
-	init_jacobi_precond(A);
-
-	m_residual = b - A * x;
-	
-
-	// The first direction given by preconditioned matrix
-	// We will build A-orthonormal directions from this
-	apply_jacobi_precond(m_residual, &m_dir);
-	Float delta = m_residual.dot(m_dir);
-	const Float delta_zero = delta;
-
-	uint32_t it = 0;
-	while (it++ < max_iterations) {
-		m_Adir.noalias() = A * m_dir;
-		Float alpha = delta / (m_dir.dot(m_Adir));
-		x += alpha * m_dir;
-
-		// The resudual is recomputed by accumulation
-		// This can accumulate error.
-		// If problems arise, use r = b - Ax
-		m_residual -= alpha * m_Adir;
-
-		Float sqNorm = m_residual.squaredNorm();
-		if (sqNorm < max_error) {
-			break;
-		}
-
-		apply_jacobi_precond(m_residual, &m_A_res_precond);
-
-		Float newDelta = m_residual.dot(m_A_res_precond);
-
-		// Gram-Schmidt A-orthonormal new direction
-		Float beta = newDelta / delta;
-		m_dir = m_A_res_precond + beta * m_dir;
-
-		delta = newDelta;
-	}
-
-	return it <= max_iterations;
-}
-
-void ConjugateGradient::apply_jacobi_precond(const Vec& b, Vec* x_) const
-{
-	assert(x_ != nullptr);
-	Vec& x = *x_;
-	assert(b.rows() == m_residual.rows());
-	assert(x.rows() == m_residual.rows());
-
-	x = m_jacobi_precond.cwiseProduct(b);
-}
-
-void ConjugateGradient::init_jacobi_precond(const SMat& A)
-{
-	for (Eigen::Index i = 0; i < A.rows(); ++i) {
-		if (A.diagonal()(i) != Float(0)) {
-			m_jacobi_precond(i) = (Float(1) / A.diagonal()(i));
-		}
-		else {
-			m_jacobi_precond(i) = Float(1.0);
-		}
-	}
-}
-
+#include "ConjugateGradient.hpp"
+
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+namespace {
+
+inline void multiply(const SMat& A, const Vec& x, Vec* y)
+{
+	y->noalias() = A * x;
+}
+
+inline void multiply(const BlockSparseMatrix& A, const Vec& x, Vec* y)
+{
+	A.multiply(x, y);
+}
+
+inline void multiply(const ConjugateGradient::LinearOperator& A, const Vec& x, Vec* y)
+{
+	A.multiply(x, y);
+}
+
+// Returns x^T * y as well
+inline Float multiply_dot(const SMat& A, const Vec& x, Vec* y, VectorKernels* kernels)
+{
+	return kernels->multiply_dot(A, x, y);
+}
+
+inline Float multiply_dot(const BlockSparseMatrix& A, const Vec& x, Vec* y, VectorKernels* kernels)
+{
+	return kernels->multiply_dot(A, x, y);
+}
+
+inline Float multiply_dot(const ConjugateGradient::LinearOperator& A, const Vec& x, Vec* y, VectorKernels* kernels)
+{
+	A.multiply(x, y);
+	return kernels->dot(x, *y);
+}
+
+inline void get_diagonal(const SMat& A, Vec* d)
+{
+	*d = A.diagonal();
+}
+
+inline void get_diagonal(const BlockSparseMatrix& A, Vec* d)
+{
+	A.diagonal(d);
+}
+
+inline void get_diagonal(const ConjugateGradient::LinearOperator& A, Vec* d)
+{
+	A.diagonal(d);
+}
+
+inline void get_diagonal_blocks(const SMat& A, std::vector<Mat3>* blocks)
+{
+	blocks->assign((size_t)A.rows() / 3, Mat3::Zero());
+	for (Eigen::Index j = 0; j < A.outerSize(); ++j) {
+		for (SMat::InnerIterator it(A, j); it; ++it) {
+			if (it.row() / 3 == j / 3) {
+				(*blocks)[j / 3](it.row() % 3, j % 3) = it.value();
+			}
+		}
+	}
+}
+
+inline void get_diagonal_blocks(const BlockSparseMatrix& A, std::vector<Mat3>* blocks)
+{
+	blocks->resize(A.block_rows());
+	for (uint32_t i = 0; i < A.block_rows(); ++i) {
+		(*blocks)[i] = A.diagonal_block(i);
+	}
+}
+
+inline void get_diagonal_blocks(const ConjugateGradient::LinearOperator& A, std::vector<Mat3>* blocks)
+{
+	A.diagonal_blocks(blocks);
+}
+
+// The incomplete Cholesky and the multigrid need the block pattern of the matrix
+inline bool factorize_incomplete_cholesky(const BlockSparseMatrix& A, IncompleteCholesky* ic)
+{
+	return ic->compute(A);
+}
+
+template<typename Matrix>
+inline bool factorize_incomplete_cholesky(const Matrix&, IncompleteCholesky*)
+{
+	return false;
+}
+
+inline bool build_multigrid(const BlockSparseMatrix& A, AlgebraicMultigrid* amg)
+{
+	amg->compute(A);
+	return true;
+}
+
+template<typename Matrix>
+inline bool build_multigrid(const Matrix&, AlgebraicMultigrid*)
+{
+	return false;
+}
+
+} // namespace
+
+void ConjugateGradient::LinearOperator::diagonal_blocks(std::vector<Mat3>* blocks) const
+{
+	Vec d(this->rows());
+	this->diagonal(&d);
+	blocks->resize((size_t)this->rows() / 3);
+	for (size_t i = 0; i < blocks->size(); ++i) {
+		(*blocks)[i] = d.segment<3>(3 * (Eigen::Index)i).asDiagonal();
+	}
+}
+
+Mat3 invert_diagonal_block(const Mat3& block)
+{
+	// Relative size of the smallest eigenvalue that is inverted
+	const Float tolerance = Float(1e-10);
+
+	const Float scale = block.cwiseAbs().maxCoeff();
+	if (scale == Float(0)) {
+		return Mat3::Identity();
+	}
+	if (std::abs(block.determinant()) > tolerance * scale * scale * scale) {
+		return block.inverse();
+	}
+
+	// Pseudo-inverse, with the null directions left as the identity
+	Eigen::SelfAdjointEigenSolver<Mat3> eigen;
+	eigen.computeDirect(block);
+	Vec3 inv_eigenvalues;
+	for (Eigen::Index k = 0; k < 3; ++k) {
+		const Float lambda = eigen.eigenvalues()(k);
+		inv_eigenvalues(k) = std::abs(lambda) > tolerance * scale ? Float(1) / lambda : Float(1);
+	}
+	return eigen.eigenvectors() * inv_eigenvalues.asDiagonal() * eigen.eigenvectors().transpose();
+}
+
+ConjugateGradient::ConjugateGradient(size_t size)
+{
+	this->resize(size);
+}
+
+void ConjugateGradient::resize(size_t size)
+{
+	m_residual.resize((Eigen::Index)size);
+	m_dir.resize((Eigen::Index)size);
+	m_Adir.resize((Eigen::Index)size);
+	m_A_res_precond.resize((Eigen::Index)size);
+	m_jacobi_precond.resize((Eigen::Index)size);
+	m_block_jacobi_precond.resize(size / 3);
+	m_history.clear();
+	m_stopping.clear();
+}
+
+bool ConjugateGradient::solve(const SMat& A, const Vec& b, Vec* x)
+{
+	return this->solve_impl(A, b, x);
+}
+
+bool ConjugateGradient::solve(const BlockSparseMatrix& A, const Vec& b, Vec* x)
+{
+	return this->solve_impl(A, b, x);
+}
+
+bool ConjugateGradient::solve(const LinearOperator& A, const Vec& b, Vec* x)
+{
+	return this->solve_impl(A, b, x);
+}
+
+template<typename Matrix>
+bool ConjugateGradient::solve_impl(const Matrix& A, const Vec& b, Vec* x_)
+{
+	assert(x_ != nullptr);
+	Vec& x = *x_;
+	assert(A.rows() == m_residual.rows());
+	assert(A.cols() == m_residual.rows());
+	assert(b.rows() == m_residual.rows());
+	assert(x.rows() == m_residual.rows());
+
+	m_active_preconditioner = m_preconditioner;
+	if (m_active_preconditioner == Preconditioner::IncompleteCholesky &&
+		!factorize_incomplete_cholesky(A, &m_incomplete_cholesky)) {
+		m_active_preconditioner = Preconditioner::BlockJacobi;
+	}
+	if (m_active_preconditioner == Preconditioner::AlgebraicMultigrid &&
+		!build_multigrid(A, &m_multigrid)) {
+		m_active_preconditioner = Preconditioner::BlockJacobi;
+	}
+
+	if (m_active_preconditioner == Preconditioner::BlockJacobi) {
+		get_diagonal_blocks(A, &m_block_jacobi_precond);
+		init_block_jacobi_precond();
+	}
+	else if (m_active_preconditioner == Preconditioner::Jacobi) {
+		get_diagonal(A, &m_jacobi_precond);
+		init_jacobi_precond();
+	}
+
+	m_history.initial_guess(b, [&A](const Vec& v, Vec* Av) { multiply(A, v, Av); }, &x);
+
+	if (m_variant == ConjugateGradientVariant::Pipelined) {
+		this->iterate_pipelined(A, b, &x);
+	}
+	else {
+		this->iterate_classic(A, b, &x);
+	}
+
+	m_history.push(x);
+	return m_stats.stop == SolverStop::Converged;
+}
+
+template<typename Matrix>
+void ConjugateGradient::iterate_classic(const Matrix& A, const Vec& b, Vec* x_)
+{
+	Vec& x = *x_;
+	multiply(A, x, &m_residual);
+	m_residual = b - m_residual;
+
+	Float sqNorm = m_kernels.dot(m_residual, m_residual);
+	m_stopping.begin(b.rows(), std::sqrt(m_kernels.dot(b, b)), std::sqrt(sqNorm));
+	const Float max_error = m_stopping.squared_tolerance();
+	const uint32_t max_iterations = m_stopping.max_iterations();
+	m_stats.tolerance = m_stopping.tolerance();
+	m_stats.stop = SolverStop::IterationLimit;
+
+	// The first direction given by preconditioned matrix
+	// We will build A-orthonormal directions from this
+	apply_precond(m_residual, &m_dir);
+	Float delta = m_kernels.dot(m_residual, m_dir);
+
+	// Each iteration is three passes over the vectors: the product with its dot product,
+	// the update of the solution and the residual with the preconditioner, and the new direction
+	uint32_t it = 0;
+	if (sqNorm <= max_error) {
+		m_stats.stop = SolverStop::Converged;
+	}
+	while (m_stats.stop == SolverStop::IterationLimit && it < max_iterations) {
+		++it;
+		const Float dAd = multiply_dot(A, m_dir, &m_Adir, &m_kernels);
+		if (!(dAd > Float(0)) || !std::isfinite(dAd)) {
+			m_stats.stop = SolverStop::Breakdown;
+			break;
+		}
+		Float alpha = delta / dAd;
+
+		// The resudual is recomputed by accumulation
+		// This can accumulate error.
+		// If problems arise, use r = b - Ax
+		Float newDelta;
+		const bool preconditioned = this->update(alpha, &x, &sqNorm, &newDelta);
+		if (sqNorm <= max_error) {
+			m_stats.stop = SolverStop::Converged;
+			break;
+		}
+
+		if (!preconditioned) {
+			apply_precond(m_residual, &m_A_res_precond);
+			newDelta = m_kernels.dot(m_residual, m_A_res_precond);
+		}
+
+		// Gram-Schmidt A-orthonormal new direction
+		Float beta = newDelta / delta;
+		m_kernels.update_direction(beta, m_A_res_precond, &m_dir);
+
+		delta = newDelta;
+	}
+
+	m_stats.iterations = it;
+	m_stats.residual = std::sqrt(sqNorm);
+}
+
+template<typename Matrix>
+void ConjugateGradient::iterate_pipelined(const Matrix& A, const Vec& b, Vec* x_)
+{
+	Vec& x = *x_;
+	VectorKernels::Pipeline& v = m_pipeline;
+	for (Vec* vector : { &v.r, &v.u, &v.w, &v.m, &v.n, &v.z, &v.q, &v.s, &v.p }) {
+		vector->setZero(x.rows());
+	}
+
+	// r = b - A * x, u = M^-1 * r and w = A * u
+	multiply(A, x, &v.r);
+	v.r = b - v.r;
+	apply_precond(v.r, &v.u);
+	multiply(A, v.u, &v.w);
+
+	// The first pass only computes the dot products, and m with a diagonal preconditioner
+	Float sums[3];
+	const bool preconditioned = this->pipelined_update(Float(0), Float(0), &x, sums);
+
+	m_stopping.begin(b.rows(), std::sqrt(m_kernels.dot(b, b)), std::sqrt(sums[2]));
+	const Float max_error = m_stopping.squared_tolerance();
+	const uint32_t max_iterations = m_stopping.max_iterations();
+	m_stats.tolerance = m_stopping.tolerance();
+	m_stats.stop = SolverStop::IterationLimit;
+
+	Float gamma_old = Float(0);
+	Float alpha_old = Float(0);
+	uint32_t it = 0;
+	while (it < max_iterations) {
+		const Float gamma = sums[0];
+		const Float delta = sums[1];
+		if (sums[2] <= max_error) {
+			m_stats.stop = SolverStop::Converged;
+			break;
+		}
+		++it;
+
+		// The scalars of the iteration only depend on the reduction of the previous pass,
+		// so the product by the system does not wait for them
+		if (!preconditioned) {
+			apply_precond(v.w, &v.m);
+		}
+		multiply(A, v.m, &v.n);
+
+		const Float beta = it > 1 ? gamma / gamma_old : Float(0);
+		const Float alpha = it > 1 ? gamma / (delta - beta * gamma / alpha_old) : gamma / delta;
+		if (!(alpha > Float(0)) || !std::isfinite(alpha)) {
+			m_stats.stop = SolverStop::Breakdown;
+			break;
+		}
+		this->pipelined_update(alpha, beta, &x, sums);
+
+		gamma_old = gamma;
+		alpha_old = alpha;
+	}
+
+	if (m_stats.stop == SolverStop::IterationLimit && sums[2] <= max_error) {
+		m_stats.stop = SolverStop::Converged;
+	}
+	m_stats.iterations = it;
+	m_stats.residual = std::sqrt(sums[2]);
+}
+
+void ConjugateGradient::apply_precond(const Vec& b, Vec* x_) const
+{
+	assert(x_ != nullptr);
+	Vec& x = *x_;
+	assert(b.rows() == m_residual.rows());
+	assert(x.rows() == m_residual.rows());
+
+	if (m_active_preconditioner == Preconditioner::IncompleteCholesky) {
+		m_incomplete_cholesky.solve(b, &x);
+	}
+	else if (m_active_preconditioner == Preconditioner::AlgebraicMultigrid) {
+		m_multigrid.solve(b, &x);
+	}
+	else if (m_active_preconditioner == Preconditioner::BlockJacobi) {
+#pragma omp parallel for
+		for (int32_t i = 0; i < (int32_t)m_block_jacobi_precond.size(); ++i) {
+			x.segment<3>(3 * i).noalias() = m_block_jacobi_precond[i] * b.segment<3>(3 * i);
+		}
+	}
+	else {
+		x = m_jacobi_precond.cwiseProduct(b);
+	}
+}
+
+bool ConjugateGradient::pipelined_update(Float alpha, Float beta, Vec* x, Float sums[3])
+{
+	if (m_active_preconditioner == Preconditioner::BlockJacobi) {
+		m_kernels.pipelined_update(alpha, beta, m_block_jacobi_precond, x, &m_pipeline, sums);
+		return true;
+	}
+	if (m_active_preconditioner == Preconditioner::Jacobi) {
+		m_kernels.pipelined_update(alpha, beta, m_jacobi_precond, x, &m_pipeline, sums);
+		return true;
+	}
+	m_kernels.pipelined_update(alpha, beta, x, &m_pipeline, sums);
+	return false;
+}
+
+bool ConjugateGradient::update(Float alpha, Vec* x, Float* rr, Float* rz)
+{
+	if (m_active_preconditioner == Preconditioner::BlockJacobi) {
+		m_kernels.update(alpha, m_dir, m_Adir, m_block_jacobi_precond, x, &m_residual, &m_A_res_precond, rr, rz);
+		return true;
+	}
+	if (m_active_preconditioner == Preconditioner::Jacobi) {
+		m_kernels.update(alpha, m_dir, m_Adir, m_jacobi_precond, x, &m_residual, &m_A_res_precond, rr, rz);
+		return true;
+	}
+
+	// The incomplete Cholesky and the multigrid are only applied if the solve goes on
+	*rr = m_kernels.update(alpha, m_dir, m_Adir, x, &m_residual);
+	return false;
+}
+
+void ConjugateGradient::init_jacobi_precond()
+{
+	for (Eigen::Index i = 0; i < m_jacobi_precond.rows(); ++i) {
+		if (m_jacobi_precond(i) != Float(0)) {
+			m_jacobi_precond(i) = (Float(1) / m_jacobi_precond(i));
+		}
+		else {
+			m_jacobi_precond(i) = Float(1.0);
+		}
+	}
+}
+
+void ConjugateGradient::init_block_jacobi_precond()
+{
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)m_block_jacobi_precond.size(); ++i) {
+		m_block_jacobi_precond[i] = invert_diagonal_block(m_block_jacobi_precond[i]);
+	}
+}
+
 } // namespace sim
\ No newline at end of file
@@ -1,34 +1,114 @@
-#pragma once
-
-#include <Eigen/Sparse>
-#include <Eigen/Dense>
-
-#include "sim/IFEM.hpp"
-
-namespace sim {
-
-class ConjugateGradient {
-public:
-
-	ConjugateGradient() = default;
-	ConjugateGradient(size_t size);
-
-	void resize(size_t size);
-
-	bool solve(const SMat& A, const Vec& b, Vec* x);
-
-private:
-
-	Vec m_residual;
-	Vec m_dir;
-	Vec m_Adir;
-	Vec m_A_res_precond;
-	Vec m_jacobi_precond;
-
-	void apply_jacobi_precond(const Vec&b, Vec* x) const;
-
-	void init_jacobi_precond(const SMat& A);
-
-}; // class ConjugateGradient
-
+#pragma once
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <vector>
+
+#include "sim/IFEM.hpp"
+#include "sim/BlockSparseMatrix.hpp"
+#include "IncompleteCholesky.hpp"
+#include "AlgebraicMultigrid.hpp"
+#include "SolutionHistory.hpp"
+#include "StoppingTest.hpp"
+#include "VectorKernels.hpp"
+
+namespace sim {
+
+class ConjugateGradient {
+public:
+
+	// Square matrix that is only available through its products
+	class LinearOperator {
+	public:
+		virtual ~LinearOperator() = default;
+		virtual Eigen::Index rows() const = 0;
+		Eigen::Index cols() const { return this->rows(); }
+		// y = A * x
+		virtual void multiply(const Vec& x, Vec* y) const = 0;
+		virtual void diagonal(Vec* d) const = 0;
+		// 3x3 diagonal blocks of the nodes, by default the diagonal without the off diagonal terms
+		virtual void diagonal_blocks(std::vector<Mat3>* blocks) const;
+	};
+
+	ConjugateGradient() = default;
+	ConjugateGradient(size_t size);
+
+	void resize(size_t size);
+
+	void set_preconditioner(Preconditioner preconditioner) { m_preconditioner = preconditioner; }
+
+	// How x is initialized by solve(). The solutions are stored until resize()
+	void set_initial_guess(InitialGuess initial_guess) { m_history.set_policy(initial_guess); }
+
+	void set_variant(ConjugateGradientVariant variant) { m_variant = variant; }
+
+	void set_stopping_policy(const StoppingPolicy& policy) { m_stopping.set_policy(policy); }
+
+	// Iterations of the last solve
+	uint32_t iterations() const { return m_stats.iterations; }
+
+	const SolverStats& stats() const { return m_stats; }
+
+	bool solve(const SMat& A, const Vec& b, Vec* x);
+
+	bool solve(const BlockSparseMatrix& A, const Vec& b, Vec* x);
+
+	bool solve(const LinearOperator& A, const Vec& b, Vec* x);
+
+private:
+
+	Vec m_residual;
+	Vec m_dir;
+	Vec m_Adir;
+	Vec m_A_res_precond;
+	Vec m_jacobi_precond;
+	std::vector<Mat3> m_block_jacobi_precond;
+	IncompleteCholesky m_incomplete_cholesky;
+	AlgebraicMultigrid m_multigrid;
+	SolutionHistory m_history;
+	StoppingTest m_stopping;
+	VectorKernels m_kernels;
+	ConjugateGradientVariant m_variant = ConjugateGradientVariant::Classic;
+	// Vectors of the pipelined variant, only allocated when it is used
+	VectorKernels::Pipeline m_pipeline;
+	Preconditioner m_preconditioner = Preconditioner::Jacobi;
+	// Preconditioner used by the current solve, after the fall backs
+	Preconditioner m_active_preconditioner = Preconditioner::Jacobi;
+	SolverStats m_stats;
+
+	void apply_precond(const Vec& b, Vec* x) const;
+
+	// x += alpha * m_dir and m_residual -= alpha * m_Adir, with r^T * r in rr.
+	// The diagonal preconditioners are applied in the same pass, with M^-1 * r in m_A_res_precond
+	// and r^T * M^-1 * r in rz. Returns false if the preconditioner was not applied
+	bool update(Float alpha, Vec* x, Float* rr, Float* rz);
+
+	// Sets the preconditioner from the diagonal of the matrix
+	void init_jacobi_precond();
+
+	// Sets the preconditioner from the diagonal blocks of the matrix
+	void init_block_jacobi_precond();
+
+	// Pipelined update of m_pipeline, with the diagonal preconditioners applied in the same pass.
+	// Returns false if the preconditioner was not applied
+	bool pipelined_update(Float alpha, Float beta, Vec* x, Float sums[3]);
+
+	template<typename Matrix>
+	bool solve_impl(const Matrix& A, const Vec& b, Vec* x);
+
+	// The iterations set m_stats
+	template<typename Matrix>
+	void iterate_classic(const Matrix& A, const Vec& b, Vec* x);
+
+	template<typename Matrix>
+	void iterate_pipelined(const Matrix& A, const Vec& b, Vec* x);
+
+}; // class ConjugateGradient
+
+// Inverse of a symmetric diagonal block for the block Jacobi preconditioner.
+// The directions of a singular block, like the ones the constraint filter removes,
+// are left unchanged as the scalar Jacobi does with a zero diagonal
+Mat3 invert_diagonal_block(const Mat3& block);
+
 } // namespace sim
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "IncompleteCholesky.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace sim {
+
+bool IncompleteCholesky::compute(const BlockSparseMatrix& A)
+{
+	assert(!A.empty());
+	if (m_factor.empty() || !m_factor.same_pattern(A)) {
+		this->analyze(A);
+	}
+
+	// Diagonal shifts tried when a pivot breaks down
+	const Float first_shift = Float(1e-3);
+	const uint32_t max_attempts = 8;
+
+	Float shift = Float(0);
+	for (uint32_t attempt = 0; attempt < max_attempts; ++attempt) {
+		m_factor = A;
+		if (this->factorize(shift, A)) {
+			return true;
+		}
+		shift = shift == Float(0) ? first_shift : Float(2) * shift;
+	}
+	return false;
+}
+
+void IncompleteCholesky::analyze(const BlockSparseMatrix& A)
+{
+	const uint32_t n = A.block_rows();
+
+	// Blocks above the diagonal by column, both for full and upper storage
+	m_column_offsets.assign(n + 1, 0);
+	for (uint32_t i = 0; i < n; ++i) {
+		for (uint32_t b = A.diagonal_index(i) + 1; b < A.row_end(i); ++b) {
+			m_column_offsets[A.block_column(b) + 1] += 1;
+		}
+	}
+	for (uint32_t i = 0; i < n; ++i) {
+		m_column_offsets[i + 1] += m_column_offsets[i];
+	}
+	m_column_blocks.resize(m_column_offsets.back());
+	m_column_rows.resize(m_column_offsets.back());
+	std::vector<uint32_t> cursor(m_column_offsets.begin(), m_column_offsets.end() - 1);
+	for (uint32_t i = 0; i < n; ++i) {
+		for (uint32_t b = A.diagonal_index(i) + 1; b < A.row_end(i); ++b) {
+			const uint32_t t = cursor[A.block_column(b)]++;
+			m_column_blocks[t] = b;
+			m_column_rows[t] = i;
+		}
+	}
+
+	// The row i of the forward pass needs the rows k < i with a block (k, i),
+	// and the row i of the backward pass needs the rows j > i with a block (i, j)
+	std::vector<uint32_t> row_levels(n, 0);
+	for (uint32_t i = 0; i < n; ++i) {
+		for (uint32_t t = m_column_offsets[i]; t < m_column_offsets[i + 1]; ++t) {
+			row_levels[i] = std::max(row_levels[i], row_levels[m_column_rows[t]] + 1);
+		}
+	}
+	build_levels(row_levels, &m_forward_levels);
+
+	std::fill(row_levels.begin(), row_levels.end(), 0);
+	for (uint32_t i = n; i-- > 0;) {
+		for (uint32_t b = A.diagonal_index(i) + 1; b < A.row_end(i); ++b) {
+			row_levels[i] = std::max(row_levels[i], row_levels[A.block_column(b)] + 1);
+		}
+	}
+	build_levels(row_levels, &m_backward_levels);
+}
+
+void IncompleteCholesky::build_levels(const std::vector<uint32_t>& row_levels, Levels* levels)
+{
+	const uint32_t num_levels = row_levels.empty() ? 0 :
+		*std::max_element(row_levels.begin(), row_levels.end()) + 1;
+
+	levels->offsets.assign(num_levels + 1, 0);
+	for (const uint32_t level : row_levels) {
+		levels->offsets[level + 1] += 1;
+	}
+	for (uint32_t l = 0; l < num_levels; ++l) {
+		levels->offsets[l + 1] += levels->offsets[l];
+	}
+
+	levels->rows.resize(row_levels.size());
+	std::vector<uint32_t> cursor(levels->offsets.begin(), levels->offsets.end() - 1);
+	for (uint32_t i = 0; i < (uint32_t)row_levels.size(); ++i) {
+		levels->rows[cursor[row_levels[i]]++] = i;
+	}
+}
+
+bool IncompleteCholesky::factorize(Float shift, const BlockSparseMatrix& A)
+{
+	BlockSparseMatrix& U = m_factor;
+	const Levels& levels = m_forward_levels;
+	bool failed = false;
+
+#pragma omp parallel
+	for (uint32_t l = 0; l + 1 < (uint32_t)levels.offsets.size(); ++l) {
+#pragma omp for schedule(static)
+		for (int32_t r = (int32_t)levels.offsets[l]; r < (int32_t)levels.offsets[l + 1]; ++r) {
+			const uint32_t i = levels.rows[r];
+			const uint32_t diagonal = U.diagonal_index(i);
+			const uint32_t end = U.row_end(i);
+
+			// F_ij = A_ij - sum_k U_ki^T * U_kj, only on the pattern of the row i
+			for (uint32_t t = m_column_offsets[i]; t < m_column_offsets[i + 1]; ++t) {
+				const uint32_t k = m_column_rows[t];
+				const Mat3 U_ki_T = U.block(m_column_blocks[t]).transpose();
+				uint32_t b = diagonal;
+				for (uint32_t bk = m_column_blocks[t]; bk < U.row_end(k); ++bk) {
+					const uint32_t j = U.block_column(bk);
+					while (b < end && U.block_column(b) < j) {
+						++b;
+					}
+					if (b == end) {
+						break;
+					}
+					if (U.block_column(b) == j) {
+						U.block(b).noalias() -= U_ki_T * U.block(bk);
+					}
+				}
+			}
+
+			// U_ii^T * U_ii = F_ii, and U_ij = U_ii^-T * F_ij
+			Mat3 F_ii = U.block(diagonal);
+			F_ii.diagonal() += shift * A.diagonal_block(i).diagonal();
+			const Eigen::LLT<Mat3> llt(F_ii);
+			if (llt.info() != Eigen::Success) {
+#pragma omp atomic write
+				failed = true;
+				continue;
+			}
+			const Mat3 inv_U_ii = Mat3(llt.matrixU()).inverse();
+			for (uint32_t b = diagonal + 1; b < end; ++b) {
+				U.block(b) = inv_U_ii.transpose() * U.block(b);
+			}
+			U.block(diagonal) = inv_U_ii;
+		}
+	}
+
+	return !failed;
+}
+
+void IncompleteCholesky::solve(const Vec& b, Vec* x_) const
+{
+	assert(x_ != nullptr);
+	Vec& x = *x_;
+	assert(b.rows() == m_factor.rows());
+	x.resize(b.rows());
+	const BlockSparseMatrix& U = m_factor;
+
+#pragma omp parallel
+	{
+		// U^T * y = b, with y stored in x
+		for (uint32_t l = 0; l + 1 < (uint32_t)m_forward_levels.offsets.size(); ++l) {
+#pragma omp for schedule(static)
+			for (int32_t r = (int32_t)m_forward_levels.offsets[l]; r < (int32_t)m_forward_levels.offsets[l + 1]; ++r) {
+				const uint32_t i = m_forward_levels.rows[r];
+				Vec3 sum = b.segment<3>(3 * (Eigen::Index)i);
+				for (uint32_t t = m_column_offsets[i]; t < m_column_offsets[i + 1]; ++t) {
+					sum.noalias() -= U.block(m_column_blocks[t]).transpose() *
+						x.segment<3>(3 * (Eigen::Index)m_column_rows[t]);
+				}
+				x.segment<3>(3 * (Eigen::Index)i).noalias() = U.diagonal_block(i).transpose() * sum;
+			}
+		}
+
+		// U * x = y
+		for (uint32_t l = 0; l + 1 < (uint32_t)m_backward_levels.offsets.size(); ++l) {
+#pragma omp for schedule(static)
+			for (int32_t r = (int32_t)m_backward_levels.offsets[l]; r < (int32_t)m_backward_levels.offsets[l + 1]; ++r) {
+				const uint32_t i = m_backward_levels.rows[r];
+				Vec3 sum = x.segment<3>(3 * (Eigen::Index)i);
+				for (uint32_t c = U.diagonal_index(i) + 1; c < U.row_end(i); ++c) {
+					sum.noalias() -= U.block(c) * x.segment<3>(3 * (Eigen::Index)U.block_column(c));
+				}
+				x.segment<3>(3 * (Eigen::Index)i).noalias() = U.diagonal_block(i) * sum;
+			}
+		}
+	}
+}
+
+} // namespace sim
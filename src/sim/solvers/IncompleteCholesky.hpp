@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+#include "sim/IFEM.hpp"
+#include "sim/BlockSparseMatrix.hpp"
+
+namespace sim {
+
+// Block incomplete Cholesky factorization IC(0), A ~= U^T * U, where U is block upper triangular
+// with the pattern of the upper block triangle of A.
+// The rows of the factorization and of the triangular solves are processed by levels,
+// the rows of a level only depend on rows of previous levels and run in parallel.
+class IncompleteCholesky {
+public:
+
+	IncompleteCholesky() = default;
+
+	// Factorizes A, which must be symmetric. The levels are rebuilt only if the pattern of A changed.
+	// If a pivot is not positive definite the factorization is repeated with a larger diagonal shift.
+	// Returns false if it did not succeed.
+	bool compute(const BlockSparseMatrix& A);
+
+	// x = (U^T * U)^-1 * b
+	void solve(const Vec& b, Vec* x) const;
+
+private:
+
+	// Blocks U_ij with j >= i are stored in the blocks of the row i from its diagonal.
+	// The diagonal blocks store the inverse of the diagonal block of U.
+	// Shares the pattern of the last factorized matrix
+	BlockSparseMatrix m_factor;
+
+	// Blocks (k, i) with k < i of each block column i, in the range
+	// [m_column_offsets[i], m_column_offsets[i + 1]), sorted by k
+	std::vector<uint32_t> m_column_offsets;
+	std::vector<uint32_t> m_column_blocks;
+	std::vector<uint32_t> m_column_rows;
+
+	// Rows of each level of the forward pass, used by the factorization and U^T * y = b,
+	// and of the backward pass U * x = y
+	struct Levels {
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> rows;
+	};
+	Levels m_forward_levels;
+	Levels m_backward_levels;
+
+	void analyze(const BlockSparseMatrix& A);
+
+	// Factorizes m_factor in place, with the diagonal blocks of A scaled by 1 + shift.
+	// Returns false if a pivot is not positive definite
+	bool factorize(Float shift, const BlockSparseMatrix& A);
+
+	// Groups the rows by level, given the level of each row
+	static void build_levels(const std::vector<uint32_t>& row_levels, Levels* levels);
+
+}; // class IncompleteCholesky
+
+} // namespace sim
@@ -0,0 +1,173 @@
+#include "ModifiedConjugateGradient.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+namespace {
+
+inline void multiply(const BlockSparseMatrix& A, const Vec& x, Vec* y)
+{
+	A.multiply(x, y);
+}
+
+inline void multiply(const ConjugateGradient::LinearOperator& A, const Vec& x, Vec* y)
+{
+	A.multiply(x, y);
+}
+
+inline void get_diagonal(const BlockSparseMatrix& A, Vec* d)
+{
+	A.diagonal(d);
+}
+
+inline void get_diagonal(const ConjugateGradient::LinearOperator& A, Vec* d)
+{
+	A.diagonal(d);
+}
+
+inline void get_diagonal_blocks(const BlockSparseMatrix& A, std::vector<Mat3>* blocks)
+{
+	blocks->resize(A.block_rows());
+	for (uint32_t i = 0; i < A.block_rows(); ++i) {
+		(*blocks)[i] = A.diagonal_block(i);
+	}
+}
+
+inline void get_diagonal_blocks(const ConjugateGradient::LinearOperator& A, std::vector<Mat3>* blocks)
+{
+	A.diagonal_blocks(blocks);
+}
+
+} // namespace
+
+ModifiedConjugateGradient::ModifiedConjugateGradient(size_t size)
+{
+	this->resize(size);
+}
+
+void ModifiedConjugateGradient::resize(size_t size)
+{
+	m_residual.resize((Eigen::Index)size);
+	m_dir.resize((Eigen::Index)size);
+	m_Adir.resize((Eigen::Index)size);
+	m_A_res_precond.resize((Eigen::Index)size);
+	m_jacobi_precond.resize((Eigen::Index)size);
+	m_block_jacobi_precond.resize(size / 3);
+	m_history.clear();
+	m_stopping.clear();
+}
+
+bool ModifiedConjugateGradient::solve(const BlockSparseMatrix& A, const Filter& S, const Vec& b, Vec* x)
+{
+	return this->solve_impl(A, S, b, x);
+}
+
+bool ModifiedConjugateGradient::solve(const ConjugateGradient::LinearOperator& A, const Filter& S,
+	const Vec& b, Vec* x)
+{
+	return this->solve_impl(A, S, b, x);
+}
+
+template<typename Matrix>
+bool ModifiedConjugateGradient::solve_impl(const Matrix& A, const Filter& S, const Vec& b, Vec* x_)
+{
+	assert(x_ != nullptr);
+	Vec& x = *x_;
+	assert(A.rows() == m_residual.rows());
+	assert(A.cols() == m_residual.rows());
+	assert(b.rows() == m_residual.rows());
+	assert(x.rows() == m_residual.rows());
+
+	if (m_preconditioner != Preconditioner::Jacobi) {
+		get_diagonal_blocks(A, &m_block_jacobi_precond);
+#pragma omp parallel for
+		for (int32_t i = 0; i < (int32_t)m_block_jacobi_precond.size(); ++i) {
+			m_block_jacobi_precond[i] = invert_diagonal_block(m_block_jacobi_precond[i]);
+		}
+	}
+	else {
+		get_diagonal(A, &m_jacobi_precond);
+		for (Eigen::Index i = 0; i < m_jacobi_precond.rows(); ++i) {
+			m_jacobi_precond(i) = m_jacobi_precond(i) != Float(0) ? Float(1) / m_jacobi_precond(i) : Float(1);
+		}
+	}
+
+	// The projection of the initial guess is done with the filtered system S * A * S and S * b
+	m_residual = b;
+	S.apply(&m_residual);
+	const Float rhs_norm = m_residual.norm();
+	m_history.initial_guess(m_residual, [&](const Vec& v, Vec* Av) {
+		m_dir = v;
+		S.apply(&m_dir);
+		multiply(A, m_dir, Av);
+		S.apply(Av);
+	}, &x);
+
+	// The initial guess and every update stay in the subspace of S
+	S.apply(&x);
+	multiply(A, x, &m_residual);
+	m_residual = b - m_residual;
+	S.apply(&m_residual);
+
+	Float sqNorm = m_residual.squaredNorm();
+	m_stopping.begin(b.rows(), rhs_norm, std::sqrt(sqNorm));
+	const Float max_error = m_stopping.squared_tolerance();
+	const uint32_t max_iterations = m_stopping.max_iterations();
+	m_stats.tolerance = m_stopping.tolerance();
+	m_stats.stop = sqNorm <= max_error ? SolverStop::Converged : SolverStop::IterationLimit;
+
+	this->apply_precond(m_residual, &m_dir);
+	S.apply(&m_dir);
+	Float delta = m_residual.dot(m_dir);
+
+	uint32_t it = 0;
+	while (m_stats.stop == SolverStop::IterationLimit && it < max_iterations) {
+		++it;
+		multiply(A, m_dir, &m_Adir);
+		S.apply(&m_Adir);
+		const Float dAd = m_dir.dot(m_Adir);
+		if (!(dAd > Float(0)) || !std::isfinite(dAd)) {
+			m_stats.stop = SolverStop::Breakdown;
+			break;
+		}
+		const Float alpha = delta / dAd;
+		x += alpha * m_dir;
+		m_residual -= alpha * m_Adir;
+
+		sqNorm = m_residual.squaredNorm();
+		if (sqNorm <= max_error) {
+			m_stats.stop = SolverStop::Converged;
+			break;
+		}
+
+		this->apply_precond(m_residual, &m_A_res_precond);
+		const Float new_delta = m_residual.dot(m_A_res_precond);
+
+		m_dir = m_A_res_precond + (new_delta / delta) * m_dir;
+		S.apply(&m_dir);
+
+		delta = new_delta;
+	}
+
+	m_stats.iterations = it;
+	m_stats.residual = std::sqrt(sqNorm);
+	m_history.push(x);
+	return m_stats.stop == SolverStop::Converged;
+}
+
+void ModifiedConjugateGradient::apply_precond(const Vec& b, Vec* x) const
+{
+	if (m_preconditioner != Preconditioner::Jacobi) {
+#pragma omp parallel for
+		for (int32_t i = 0; i < (int32_t)m_block_jacobi_precond.size(); ++i) {
+			x->segment<3>(3 * i).noalias() = m_block_jacobi_precond[i] * b.segment<3>(3 * i);
+		}
+	}
+	else {
+		*x = m_jacobi_precond.cwiseProduct(b);
+	}
+}
+
+} // namespace sim
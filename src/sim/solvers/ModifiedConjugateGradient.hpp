@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include "sim/IFEM.hpp"
+#include "sim/BlockSparseMatrix.hpp"
+#include "ConjugateGradient.hpp"
+#include "SolutionHistory.hpp"
+#include "StoppingTest.hpp"
+
+namespace sim {
+
+// Modified preconditioned conjugate gradient [Baraff and Witkin 1998].
+// Solves A * x = b in the subspace of the filter S, a projection applied to the vectors
+// inside the iteration, so the matrix is never modified by the constraints.
+class ModifiedConjugateGradient {
+public:
+
+	// Block diagonal projection S that removes the constrained components of a vector
+	class Filter {
+	public:
+		virtual ~Filter() = default;
+		// x = S * x
+		virtual void apply(Vec* x) const = 0;
+	};
+
+	ModifiedConjugateGradient() = default;
+	ModifiedConjugateGradient(size_t size);
+
+	void resize(size_t size);
+
+	void set_preconditioner(Preconditioner preconditioner) { m_preconditioner = preconditioner; }
+
+	// How x is initialized by solve(). The solutions are stored until resize()
+	void set_initial_guess(InitialGuess initial_guess) { m_history.set_policy(initial_guess); }
+
+	// The norms of the stopping criteria are the ones of the filtered vectors
+	void set_stopping_policy(const StoppingPolicy& policy) { m_stopping.set_policy(policy); }
+
+	// Iterations of the last solve
+	uint32_t iterations() const { return m_stats.iterations; }
+
+	const SolverStats& stats() const { return m_stats; }
+
+	bool solve(const BlockSparseMatrix& A, const Filter& S, const Vec& b, Vec* x);
+
+	bool solve(const ConjugateGradient::LinearOperator& A, const Filter& S, const Vec& b, Vec* x);
+
+private:
+
+	Vec m_residual;
+	Vec m_dir;
+	Vec m_Adir;
+	Vec m_A_res_precond;
+	Vec m_jacobi_precond;
+	std::vector<Mat3> m_block_jacobi_precond;
+	// The incomplete Cholesky and the multigrid are replaced by block Jacobi,
+	// as the filter is applied outside the matrix
+	Preconditioner m_preconditioner = Preconditioner::Jacobi;
+	SolutionHistory m_history;
+	StoppingTest m_stopping;
+	SolverStats m_stats;
+
+	void apply_precond(const Vec& b, Vec* x) const;
+
+	template<typename Matrix>
+	bool solve_impl(const Matrix& A, const Filter& S, const Vec& b, Vec* x);
+
+}; // class ModifiedConjugateGradient
+
+} // namespace sim
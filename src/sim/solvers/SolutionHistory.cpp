@@ -0,0 +1,113 @@
+#include "SolutionHistory.hpp"
+
+#include <algorithm>
+
+namespace sim {
+
+uint32_t SolutionHistory::depth() const
+{
+	switch (m_policy) {
+	case InitialGuess::Zero:
+		return 0;
+	case InitialGuess::Previous:
+		return 1;
+	case InitialGuess::LinearExtrapolation:
+		return 2;
+	case InitialGuess::QuadraticExtrapolation:
+		return 3;
+	case InitialGuess::Projection:
+		return MAX_SOLUTIONS;
+	}
+	return 0;
+}
+
+void SolutionHistory::push(const Vec& x)
+{
+	const uint32_t depth = this->depth();
+	if (depth == 0) {
+		m_size = 0;
+		return;
+	}
+	if (m_solutions.size() < depth) {
+		m_solutions.resize(depth);
+	}
+
+	// The oldest solution is overwritten, the swaps do not copy the vectors
+	m_size = std::min(m_size + 1, depth);
+	for (uint32_t k = m_size - 1; k > 0; --k) {
+		m_solutions[k].swap(m_solutions[k - 1]);
+	}
+	m_solutions[0] = x;
+}
+
+void SolutionHistory::extrapolate(Vec* x) const
+{
+	// Polynomial through the last solutions, evaluated at the next solve
+	switch (std::min(m_size, this->depth())) {
+	case 1:
+		*x = m_solutions[0];
+		break;
+	case 2:
+		*x = Float(2) * m_solutions[0] - m_solutions[1];
+		break;
+	default:
+		*x = Float(3) * (m_solutions[0] - m_solutions[1]) + m_solutions[2];
+		break;
+	}
+}
+
+uint32_t SolutionHistory::build_basis()
+{
+	// Relative norm left after the orthogonalization under which a solution is skipped
+	const Float tolerance = Float(1e-6);
+
+	m_basis.resize(m_size);
+	uint32_t n = 0;
+	for (uint32_t k = 0; k < m_size; ++k) {
+		Vec& v = m_basis[n];
+		v = m_solutions[k];
+		const Float norm = v.norm();
+		if (norm == Float(0)) {
+			continue;
+		}
+		for (uint32_t j = 0; j < n; ++j) {
+			v -= m_basis[j].dot(v) * m_basis[j];
+		}
+		const Float residual_norm = v.norm();
+		if (residual_norm <= tolerance * norm) {
+			continue;
+		}
+		v /= residual_norm;
+		++n;
+	}
+	return n;
+}
+
+void SolutionHistory::project(const Vec& b, uint32_t n, Vec* x) const
+{
+	typedef Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic> DenseMat;
+
+	DenseMat G(n, n);
+	Vec r(n);
+	for (uint32_t i = 0; i < n; ++i) {
+		r(i) = m_basis[i].dot(b);
+		for (uint32_t j = i; j < n; ++j) {
+			G(i, j) = m_basis[i].dot(m_A_basis[j]);
+			G(j, i) = G(i, j);
+		}
+	}
+
+	// The Galerkin solution minimizes the error in the norm of A over the span of the solutions
+	const Eigen::LDLT<DenseMat> ldlt(G);
+	if (ldlt.info() != Eigen::Success || !ldlt.isPositive()) {
+		return;
+	}
+	const Vec y = ldlt.solve(r);
+
+	x->setZero();
+	for (uint32_t i = 0; i < n; ++i) {
+		*x += y(i) * m_basis[i];
+	}
+}
+
+} // namespace sim
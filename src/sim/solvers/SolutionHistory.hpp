@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <cassert>
+
+#include "sim/IFEM.hpp"
+
+namespace sim {
+
+// Solutions of the last solves of a sequence of similar systems, like the substeps of a frame,
+// used to build the initial guess of the next solve
+class SolutionHistory {
+public:
+
+	SolutionHistory() = default;
+
+	void set_policy(InitialGuess policy) { m_policy = policy; }
+
+	// Forgets the stored solutions, when the unknowns of the system change
+	void clear() { m_size = 0; }
+
+	// Sets x to the initial guess of A * x = b, where multiply(v, &Av) computes A * v.
+	// The extrapolations use a lower order until enough solutions are stored,
+	// and x is left unchanged while there are none
+	template<typename Multiply>
+	void initial_guess(const Vec& b, const Multiply& multiply, Vec* x);
+
+	// Stores the solution of the last solve
+	void push(const Vec& x);
+
+private:
+
+	// Largest number of solutions spanning the projection
+	static constexpr uint32_t MAX_SOLUTIONS = 4;
+
+	InitialGuess m_policy = InitialGuess::Previous;
+
+	// Stored solutions from the most recent, only the first m_size are valid
+	std::vector<Vec> m_solutions;
+	uint32_t m_size = 0;
+
+	// Orthonormal basis of the stored solutions, and its products by the system
+	std::vector<Vec> m_basis;
+	std::vector<Vec> m_A_basis;
+
+	// Number of solutions used by the policy
+	uint32_t depth() const;
+
+	// x = 2 * x_1 - x_2, or the quadratic or constant versions
+	void extrapolate(Vec* x) const;
+
+	// Orthonormalizes the stored solutions into m_basis, and returns its size.
+	// Solutions that are almost a combination of the newer ones are skipped
+	uint32_t build_basis();
+
+	// x = V * (V^T * A * V)^-1 * V^T * b, with V the first n vectors of m_basis
+	void project(const Vec& b, uint32_t n, Vec* x) const;
+
+}; // class SolutionHistory
+
+template<typename Multiply>
+void SolutionHistory::initial_guess(const Vec& b, const Multiply& multiply, Vec* x)
+{
+	assert(x != nullptr);
+	if (m_policy == InitialGuess::Zero) {
+		x->setZero();
+		return;
+	}
+	if (m_size == 0) {
+		return;
+	}
+	assert(m_solutions[0].rows() == x->rows());
+
+	if (m_policy == InitialGuess::Projection) {
+		const uint32_t n = this->build_basis();
+		if (n == 0) {
+			return;
+		}
+		m_A_basis.resize(n);
+		for (uint32_t k = 0; k < n; ++k) {
+			m_A_basis[k].resize(x->rows());
+			multiply(m_basis[k], &m_A_basis[k]);
+		}
+		this->project(b, n, x);
+	}
+	else {
+		this->extrapolate(x);
+	}
+}
+
+} // namespace sim
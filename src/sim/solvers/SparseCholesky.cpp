@@ -0,0 +1,599 @@
+#include "SparseCholesky.hpp"
+
+#include <Eigen/Sparse>
+#include <Eigen/OrderingMethods>
+
+#include <omp.h>
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+
+namespace sim {
+
+SparseCholesky::PanelRef SparseCholesky::panel(uint32_t s)
+{
+	const Eigen::Index rows = 3 * (Eigen::Index)(m_row_offsets[s + 1] - m_row_offsets[s]);
+	const Eigen::Index cols = 3 * (Eigen::Index)(m_super_begin[s + 1] - m_super_begin[s]);
+	return PanelRef(m_values.data() + m_value_offsets[s], rows, cols);
+}
+
+SparseCholesky::ConstPanelRef SparseCholesky::panel(uint32_t s) const
+{
+	const Eigen::Index rows = 3 * (Eigen::Index)(m_row_offsets[s + 1] - m_row_offsets[s]);
+	const Eigen::Index cols = 3 * (Eigen::Index)(m_super_begin[s + 1] - m_super_begin[s]);
+	return ConstPanelRef(m_values.data() + m_value_offsets[s], rows, cols);
+}
+
+bool SparseCholesky::compute(const BlockSparseMatrix& A)
+{
+	assert(!A.empty());
+	if (!A.has_pattern(m_pattern)) {
+		this->analyze(A);
+	}
+
+	std::fill(m_values.begin(), m_values.end(), Float(0));
+#pragma omp parallel for
+	for (int32_t i = 0; i < (int32_t)A.block_rows(); ++i) {
+		for (uint32_t b = A.row_begin(i); b < A.row_end(i); ++b) {
+			const size_t target = m_block_targets[b];
+			if (target == NO_TARGET) {
+				continue;
+			}
+			const uint32_t column = std::min(m_position[i], m_position[A.block_column(b)]);
+			const uint32_t s = m_node_super[column];
+			const Eigen::Index ld = 3 * (Eigen::Index)(m_row_offsets[s + 1] - m_row_offsets[s]);
+			Eigen::Map<Mat3, 0, Eigen::OuterStride<>> L_block(m_values.data() + target, Eigen::OuterStride<>(ld));
+			const Eigen::Map<const Mat3> A_block(A.values() + 9 * (size_t)b);
+			if (m_block_transposed[b]) {
+				L_block = A_block.transpose();
+			}
+			else {
+				L_block = A_block;
+			}
+		}
+	}
+
+	// Left looking: each supernode receives the updates of the supernodes below it in the
+	// elimination tree before it is factorized. The supernodes waiting to update s are linked
+	// from m_update_heads[s], and m_update_rows[d] is the first row of d that is not used yet
+	const uint32_t num_supernodes = this->num_supernodes();
+	m_update_heads.assign(num_supernodes, NO_SUPERNODE);
+	m_update_next.assign(num_supernodes, NO_SUPERNODE);
+	m_update_rows.assign(num_supernodes, 0);
+	m_workspaces.resize(std::max(m_workspaces.size(), (size_t)omp_get_max_threads()));
+	for (Workspace& workspace : m_workspaces) {
+		workspace.relative_rows.resize(m_order.size());
+	}
+
+	// The subtrees only update their own supernodes, and the updates that they send above them
+	// are linked afterwards in order
+	bool positive = true;
+#pragma omp parallel for schedule(dynamic, 1)
+	for (int32_t t = 0; t < (int32_t)m_subtrees.size(); ++t) {
+		Workspace* workspace = &m_workspaces[omp_get_thread_num()];
+		const uint32_t end = m_subtrees[t].second;
+		for (uint32_t s = m_subtrees[t].first; s < end; ++s) {
+			if (!this->factorize_supernode(s, end, workspace)) {
+#pragma omp atomic write
+				positive = false;
+				break;
+			}
+		}
+	}
+	if (!positive) {
+		return false;
+	}
+
+	for (const std::pair<uint32_t, uint32_t>& subtree : m_subtrees) {
+		for (uint32_t d = subtree.first; d < subtree.second; ++d) {
+			this->link_update(d, num_supernodes);
+		}
+	}
+	return this->factorize_top_supernodes();
+}
+
+bool SparseCholesky::factorize_supernode(uint32_t s, uint32_t link_end, Workspace* workspace)
+{
+	this->set_relative_rows(s, workspace);
+	for (uint32_t d = m_update_heads[s]; d != NO_SUPERNODE;) {
+		const uint32_t next = m_update_next[d];
+		const uint32_t last = this->update_columns_end(d, s);
+		this->update_supernode(d, s, last, m_update_rows[d], m_row_offsets[d + 1], workspace);
+		m_update_rows[d] = last;
+		this->link_update(d, link_end);
+		d = next;
+	}
+
+	// L11 * L11^T = A11 and L21 = A21 * L11^-T
+	PanelRef L = this->panel(s);
+	const Eigen::Index n = L.cols();
+	Eigen::Ref<DenseMat> L11 = L.topLeftCorner(n, n);
+	Eigen::LLT<Eigen::Ref<DenseMat>> llt(L11);
+	if (llt.info() != Eigen::Success) {
+		return false;
+	}
+	if (L.rows() > n) {
+		L11.triangularView<Eigen::Lower>().transpose().solveInPlace<Eigen::OnTheRight>(L.bottomRows(L.rows() - n));
+	}
+
+	m_update_rows[s] = m_row_offsets[s] + (m_super_begin[s + 1] - m_super_begin[s]);
+	this->link_update(s, link_end);
+	return true;
+}
+
+bool SparseCholesky::factorize_top_supernodes()
+{
+	// Each supernode is split in slabs of SLAB_NODES rows, and each thread updates and solves
+	// whole slabs. The products of a slab are the same for any number of threads, and Eigen
+	// does not split them again inside the parallel region
+	bool positive = true;
+#pragma omp parallel
+	{
+		Workspace* workspace = &m_workspaces[omp_get_thread_num()];
+		for (const uint32_t s : m_top_supernodes) {
+			this->set_relative_rows(s, workspace);
+			const uint32_t num_rows = m_row_offsets[s + 1] - m_row_offsets[s];
+			const uint32_t num_columns = m_super_begin[s + 1] - m_super_begin[s];
+
+#pragma omp single
+			{
+				m_top_updates.clear();
+				m_top_update_ends.clear();
+				for (uint32_t d = m_update_heads[s]; d != NO_SUPERNODE; d = m_update_next[d]) {
+					m_top_updates.push_back(d);
+					m_top_update_ends.push_back(this->update_columns_end(d, s));
+				}
+			}
+
+#pragma omp for schedule(static)
+			for (int32_t slab = 0; slab < (int32_t)((num_rows + SLAB_NODES - 1) / SLAB_NODES); ++slab) {
+				const uint32_t slab_begin = (uint32_t)slab * SLAB_NODES;
+				const uint32_t slab_end = std::min(num_rows, slab_begin + SLAB_NODES);
+				for (size_t k = 0; k < m_top_updates.size(); ++k) {
+					// Rows of d that fall in the slab, which are consecutive as both lists are sorted
+					const uint32_t d = m_top_updates[k];
+					const uint32_t* rows = m_rows.data();
+					const auto in_slab = [&](uint32_t end) {
+						return [&, end](uint32_t r) { return workspace->relative_rows[r] < end; };
+					};
+					const uint32_t begin = (uint32_t)(std::partition_point(rows + m_update_rows[d],
+						rows + m_row_offsets[d + 1], in_slab(slab_begin)) - rows);
+					const uint32_t end = (uint32_t)(std::partition_point(rows + begin,
+						rows + m_row_offsets[d + 1], in_slab(slab_end)) - rows);
+					if (begin < end) {
+						this->update_supernode(d, s, m_top_update_ends[k], begin, end, workspace);
+					}
+				}
+			}
+
+#pragma omp single
+			{
+				for (size_t k = 0; k < m_top_updates.size(); ++k) {
+					m_update_rows[m_top_updates[k]] = m_top_update_ends[k];
+				}
+				for (const uint32_t d : m_top_updates) {
+					this->link_update(d, this->num_supernodes());
+				}
+
+				Eigen::Ref<DenseMat> L11 = this->panel(s).topLeftCorner(3 * num_columns, 3 * num_columns);
+				Eigen::LLT<Eigen::Ref<DenseMat>> llt(L11);
+				positive = llt.info() == Eigen::Success;
+			}
+			if (!positive) {
+				break;
+			}
+
+			// L21 = A21 * L11^-T, by slabs of rows
+			const uint32_t num_below = num_rows - num_columns;
+#pragma omp for schedule(static)
+			for (int32_t slab = 0; slab < (int32_t)((num_below + SLAB_NODES - 1) / SLAB_NODES); ++slab) {
+				const uint32_t slab_begin = num_columns + (uint32_t)slab * SLAB_NODES;
+				const uint32_t slab_size = std::min(num_rows - slab_begin, SLAB_NODES);
+				PanelRef L = this->panel(s);
+				L.topLeftCorner(L.cols(), L.cols()).triangularView<Eigen::Lower>().transpose()
+					.solveInPlace<Eigen::OnTheRight>(L.middleRows(3 * (Eigen::Index)slab_begin, 3 * (Eigen::Index)slab_size));
+			}
+
+#pragma omp single
+			{
+				m_update_rows[s] = m_row_offsets[s] + num_columns;
+				this->link_update(s, this->num_supernodes());
+			}
+		}
+	}
+	return positive;
+}
+
+void SparseCholesky::set_relative_rows(uint32_t s, Workspace* workspace) const
+{
+	const uint32_t row_begin = m_row_offsets[s];
+	const uint32_t num_rows = m_row_offsets[s + 1] - row_begin;
+	for (uint32_t r = 0; r < num_rows; ++r) {
+		workspace->relative_rows[m_rows[row_begin + r]] = r;
+	}
+}
+
+void SparseCholesky::link_update(uint32_t d, uint32_t link_end)
+{
+	const uint32_t row = m_update_rows[d];
+	if (row == m_row_offsets[d + 1]) {
+		return;
+	}
+	const uint32_t s = m_node_super[m_rows[row]];
+	if (s < link_end) {
+		m_update_next[d] = m_update_heads[s];
+		m_update_heads[s] = d;
+	}
+}
+
+uint32_t SparseCholesky::update_columns_end(uint32_t d, uint32_t s) const
+{
+	const uint32_t end = m_row_offsets[d + 1];
+	const uint32_t s_end = m_super_begin[s + 1];
+	uint32_t last = m_update_rows[d];
+	while (last < end && m_rows[last] < s_end) {
+		++last;
+	}
+	return last;
+}
+
+void SparseCholesky::update_supernode(uint32_t d, uint32_t s, uint32_t last, uint32_t begin, uint32_t end,
+	Workspace* workspace)
+{
+	// Columns of s, from the rows [first, last) of d, and rows of s, from the rows [begin, end)
+	const uint32_t first = m_update_rows[d];
+	const uint32_t columns_end = std::min(last, end);
+	if (columns_end <= first) {
+		return;
+	}
+
+	const ConstPanelRef L_d = static_cast<const SparseCholesky*>(this)->panel(d);
+	const uint32_t d_begin = m_row_offsets[d];
+	DenseMat& update = workspace->update;
+	update.resize(3 * (Eigen::Index)(end - begin), 3 * (Eigen::Index)(columns_end - first));
+	update.noalias() = L_d.middleRows(3 * (Eigen::Index)(begin - d_begin), update.rows()) *
+		L_d.middleRows(3 * (Eigen::Index)(first - d_begin), update.cols()).transpose();
+
+	// Only the lower triangle of the diagonal block of s is used
+	PanelRef L_s = this->panel(s);
+	const uint32_t s_begin = m_super_begin[s];
+	for (uint32_t c = first; c < columns_end; ++c) {
+		const Eigen::Index col = 3 * (Eigen::Index)(m_rows[c] - s_begin);
+		for (uint32_t r = std::max(c, begin); r < end; ++r) {
+			const Eigen::Index row = 3 * (Eigen::Index)workspace->relative_rows[m_rows[r]];
+			L_s.block<3, 3>(row, col) -= update.block<3, 3>(3 * (Eigen::Index)(r - begin), 3 * (Eigen::Index)(c - first));
+		}
+	}
+}
+
+void SparseCholesky::solve(const Vec& b, Vec* x) const
+{
+	assert(x != nullptr);
+	assert(b.rows() == 3 * (Eigen::Index)m_order.size());
+	const uint32_t num_nodes = (uint32_t)m_order.size();
+	const uint32_t num_supernodes = this->num_supernodes();
+
+	m_y.resize(b.rows());
+	for (uint32_t k = 0; k < num_nodes; ++k) {
+		m_y.segment<3>(3 * (Eigen::Index)k) = b.segment<3>(3 * (Eigen::Index)m_order[k]);
+	}
+
+	// L * y = P * b
+	for (uint32_t s = 0; s < num_supernodes; ++s) {
+		const ConstPanelRef L = this->panel(s);
+		const Eigen::Index n = L.cols();
+		auto y_s = m_y.segment(3 * (Eigen::Index)m_super_begin[s], n);
+		L.topLeftCorner(n, n).triangularView<Eigen::Lower>().solveInPlace(y_s);
+		if (L.rows() > n) {
+			m_below.noalias() = L.bottomRows(L.rows() - n) * y_s;
+			const uint32_t row_begin = m_row_offsets[s] + m_super_begin[s + 1] - m_super_begin[s];
+			for (uint32_t r = row_begin; r < m_row_offsets[s + 1]; ++r) {
+				m_y.segment<3>(3 * (Eigen::Index)m_rows[r]) -= m_below.segment<3>(3 * (Eigen::Index)(r - row_begin));
+			}
+		}
+	}
+
+	// L^T * z = y
+	for (uint32_t s = num_supernodes; s-- > 0;) {
+		const ConstPanelRef L = this->panel(s);
+		const Eigen::Index n = L.cols();
+		auto y_s = m_y.segment(3 * (Eigen::Index)m_super_begin[s], n);
+		if (L.rows() > n) {
+			const uint32_t row_begin = m_row_offsets[s] + m_super_begin[s + 1] - m_super_begin[s];
+			m_below.resize(L.rows() - n);
+			for (uint32_t r = row_begin; r < m_row_offsets[s + 1]; ++r) {
+				m_below.segment<3>(3 * (Eigen::Index)(r - row_begin)) = m_y.segment<3>(3 * (Eigen::Index)m_rows[r]);
+			}
+			y_s.noalias() -= L.bottomRows(L.rows() - n).transpose() * m_below;
+		}
+		L.topLeftCorner(n, n).triangularView<Eigen::Lower>().transpose().solveInPlace(y_s);
+	}
+
+	// x = P^T * z
+	x->resize(b.rows());
+	for (uint32_t k = 0; k < num_nodes; ++k) {
+		x->segment<3>(3 * (Eigen::Index)m_order[k]) = m_y.segment<3>(3 * (Eigen::Index)k);
+	}
+}
+
+void SparseCholesky::build_subtrees()
+{
+	// Operations of the factorization of each supernode and the updates it sends, added over
+	// its subtree. The supernodes are in postorder, so each subtree is the range from its first
+	// supernode to its root
+	const uint32_t num_supernodes = this->num_supernodes();
+	std::vector<double> work(num_supernodes, 0.0);
+	std::vector<uint32_t> first(num_supernodes);
+	std::iota(first.begin(), first.end(), 0);
+	std::vector<uint32_t> parent(num_supernodes, NO_SUPERNODE);
+	double total_work = 0.0;
+	for (uint32_t s = 0; s < num_supernodes; ++s) {
+		const uint32_t columns = m_super_begin[s + 1] - m_super_begin[s];
+		const double n = 3.0 * columns;
+		const double below = 3.0 * (m_row_offsets[s + 1] - m_row_offsets[s] - columns);
+		const double own_work = n * n * n / 3.0 + n * n * below + n * below * below;
+		work[s] += own_work;
+		total_work += own_work;
+		if (below > 0.0) {
+			parent[s] = m_node_super[m_rows[m_row_offsets[s] + columns]];
+			work[parent[s]] += work[s];
+			first[parent[s]] = std::min(first[parent[s]], first[s]);
+		}
+	}
+
+	const double limit = total_work / SUBTREE_TASKS;
+	std::vector<double> subtree_work;
+	m_subtrees.clear();
+	m_top_supernodes.clear();
+	for (uint32_t s = 0; s < num_supernodes; ++s) {
+		if (work[s] > limit) {
+			m_top_supernodes.push_back(s);
+		}
+		else if (parent[s] == NO_SUPERNODE || work[parent[s]] > limit) {
+			m_subtrees.emplace_back(first[s], s + 1);
+			subtree_work.push_back(work[s]);
+		}
+	}
+
+	// The largest subtrees first, so the threads finish together
+	std::vector<uint32_t> order(m_subtrees.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&subtree_work](uint32_t a, uint32_t b) {
+		return subtree_work[a] > subtree_work[b];
+	});
+	std::vector<std::pair<uint32_t, uint32_t>> subtrees(m_subtrees.size());
+	for (size_t k = 0; k < order.size(); ++k) {
+		subtrees[k] = m_subtrees[order[k]];
+	}
+	m_subtrees = std::move(subtrees);
+}
+
+std::vector<uint32_t> SparseCholesky::order_nodes(const std::vector<std::vector<uint32_t>>& adjacency)
+{
+	const uint32_t n = (uint32_t)adjacency.size();
+
+	// Approximate minimum degree on the graph of the nodes
+	std::vector<Eigen::Triplet<Float>> triplets;
+	for (uint32_t i = 0; i < n; ++i) {
+		triplets.emplace_back(i, i, Float(1));
+		for (const uint32_t j : adjacency[i]) {
+			triplets.emplace_back(i, j, Float(1));
+		}
+	}
+	SMat graph(n, n);
+	graph.setFromTriplets(triplets.begin(), triplets.end());
+	Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, SMat::StorageIndex> amd;
+	Eigen::AMDOrdering<SMat::StorageIndex>()(graph, amd);
+	std::vector<uint32_t> amd_order(n);
+	std::vector<uint32_t> amd_position(n);
+	for (uint32_t k = 0; k < n; ++k) {
+		amd_order[k] = (uint32_t)amd.indices()[k];
+		amd_position[amd_order[k]] = k;
+	}
+
+	// Elimination tree [Liu 1986], with path compression of the ancestors
+	std::vector<uint32_t> parent(n, NO_SUPERNODE);
+	std::vector<uint32_t> ancestor(n, NO_SUPERNODE);
+	for (uint32_t k = 0; k < n; ++k) {
+		for (const uint32_t neighbour : adjacency[amd_order[k]]) {
+			uint32_t i = amd_position[neighbour];
+			if (i >= k) {
+				continue;
+			}
+			while (ancestor[i] != NO_SUPERNODE && ancestor[i] != k) {
+				const uint32_t next = ancestor[i];
+				ancestor[i] = k;
+				i = next;
+			}
+			if (ancestor[i] == NO_SUPERNODE) {
+				ancestor[i] = k;
+				parent[i] = k;
+			}
+		}
+	}
+
+	// Postorder by depth first search from the roots, visiting the children in order
+	std::vector<uint32_t> child_offsets(n + 1, 0);
+	for (uint32_t k = 0; k < n; ++k) {
+		if (parent[k] != NO_SUPERNODE) {
+			child_offsets[parent[k] + 1] += 1;
+		}
+	}
+	for (uint32_t k = 0; k < n; ++k) {
+		child_offsets[k + 1] += child_offsets[k];
+	}
+	std::vector<uint32_t> children(child_offsets.back());
+	std::vector<uint32_t> cursor(child_offsets.begin(), child_offsets.end() - 1);
+	for (uint32_t k = 0; k < n; ++k) {
+		if (parent[k] != NO_SUPERNODE) {
+			children[cursor[parent[k]]++] = k;
+		}
+	}
+
+	std::vector<uint32_t> postorder;
+	postorder.reserve(n);
+	std::vector<std::pair<uint32_t, uint32_t>> stack;
+	for (uint32_t root = 0; root < n; ++root) {
+		if (parent[root] != NO_SUPERNODE) {
+			continue;
+		}
+		stack.emplace_back(root, child_offsets[root]);
+		while (!stack.empty()) {
+			std::pair<uint32_t, uint32_t>& top = stack.back();
+			if (top.second < child_offsets[top.first + 1]) {
+				const uint32_t child = children[top.second++];
+				stack.emplace_back(child, child_offsets[child]);
+			}
+			else {
+				postorder.push_back(top.first);
+				stack.pop_back();
+			}
+		}
+	}
+	assert(postorder.size() == n);
+
+	std::vector<uint32_t> post_position(n);
+	m_order.resize(n);
+	for (uint32_t k = 0; k < n; ++k) {
+		post_position[postorder[k]] = k;
+		m_order[k] = amd_order[postorder[k]];
+	}
+	m_position.resize(n);
+	for (uint32_t k = 0; k < n; ++k) {
+		m_position[m_order[k]] = k;
+	}
+
+	std::vector<uint32_t> post_parent(n, NO_SUPERNODE);
+	for (uint32_t k = 0; k < n; ++k) {
+		if (parent[k] != NO_SUPERNODE) {
+			post_parent[post_position[k]] = post_position[parent[k]];
+		}
+	}
+	return post_parent;
+}
+
+void SparseCholesky::analyze(const BlockSparseMatrix& A)
+{
+	const uint32_t n = A.block_rows();
+
+	std::vector<std::vector<uint32_t>> adjacency(n);
+	for (uint32_t i = 0; i < n; ++i) {
+		for (uint32_t b = A.row_begin(i); b < A.row_end(i); ++b) {
+			const uint32_t j = A.block_column(b);
+			if (j != i) {
+				adjacency[i].push_back(j);
+				if (A.upper_only()) {
+					adjacency[j].push_back(i);
+				}
+			}
+		}
+	}
+	const std::vector<uint32_t> parent = this->order_nodes(adjacency);
+
+	// Structure of each column of L below the diagonal, the nodes of A below the diagonal
+	// merged with the structure of the children in the elimination tree
+	std::vector<std::vector<uint32_t>> structure(n);
+	std::vector<uint32_t> marks(n, NO_SUPERNODE);
+	for (uint32_t k = 0; k < n; ++k) {
+		// The children have already added their structure, which may repeat nodes
+		std::vector<uint32_t>& column = structure[k];
+		marks[k] = k;
+		uint32_t size = 0;
+		for (const uint32_t i : column) {
+			if (marks[i] != k) {
+				marks[i] = k;
+				column[size++] = i;
+			}
+		}
+		column.resize(size);
+		for (const uint32_t neighbour : adjacency[m_order[k]]) {
+			const uint32_t i = m_position[neighbour];
+			if (i > k && marks[i] != k) {
+				marks[i] = k;
+				column.push_back(i);
+			}
+		}
+		std::vector<uint32_t>().swap(adjacency[m_order[k]]);
+		std::sort(column.begin(), column.end());
+		if (parent[k] == NO_SUPERNODE) {
+			continue;
+		}
+		std::vector<uint32_t>& parent_column = structure[parent[k]];
+		for (const uint32_t i : column) {
+			if (i != parent[k]) {
+				parent_column.push_back(i);
+			}
+		}
+	}
+
+	// Relaxed supernodes [Ashcraft and Grimes 1989]: k joins the supernode of k - 1 if it is
+	// its parent, so the structure of the supernode is still the one of its last node, and the
+	// zeros stored by the supernode are a small part of its entries, counted in blocks.
+	// Larger panels make the dense products faster
+	m_super_begin.clear();
+	m_node_super.resize(n);
+	size_t nonzeros = 0;
+	for (uint32_t k = 0; k < n; ++k) {
+		const size_t below = structure[k].size();
+		bool joins = false;
+		if (k > 0 && parent[k - 1] == k) {
+			const size_t columns = k - m_super_begin.back() + 1;
+			const size_t entries = columns * (columns + 1) / 2 + columns * below;
+			const size_t merged_nonzeros = nonzeros + 1 + below;
+			joins = columns <= RELAXED_COLUMNS || entries - merged_nonzeros <= RELAXED_ZEROS * entries;
+		}
+		if (!joins) {
+			m_super_begin.push_back(k);
+			nonzeros = 0;
+		}
+		nonzeros += 1 + below;
+		m_node_super[k] = (uint32_t)m_super_begin.size() - 1;
+	}
+	m_super_begin.push_back(n);
+
+	const uint32_t num_supernodes = this->num_supernodes();
+	m_row_offsets.assign(num_supernodes + 1, 0);
+	m_value_offsets.assign(num_supernodes + 1, 0);
+	m_rows.clear();
+	for (uint32_t s = 0; s < num_supernodes; ++s) {
+		const uint32_t last = m_super_begin[s + 1] - 1;
+		for (uint32_t k = m_super_begin[s]; k <= last; ++k) {
+			m_rows.push_back(k);
+		}
+		m_rows.insert(m_rows.end(), structure[last].begin(), structure[last].end());
+		m_row_offsets[s + 1] = (uint32_t)m_rows.size();
+
+		const size_t rows = 3 * (size_t)(m_row_offsets[s + 1] - m_row_offsets[s]);
+		const size_t cols = 3 * (size_t)(m_super_begin[s + 1] - m_super_begin[s]);
+		m_value_offsets[s + 1] = m_value_offsets[s] + rows * cols;
+	}
+	m_values.resize(m_value_offsets.back());
+	this->build_subtrees();
+
+	// Position of each block of A in the panels, as the block (row, column) of L with row >= column
+	m_block_targets.assign(A.num_blocks(), NO_TARGET);
+	m_block_transposed.assign(A.num_blocks(), false);
+	for (uint32_t i = 0; i < n; ++i) {
+		for (uint32_t b = A.row_begin(i); b < A.row_end(i); ++b) {
+			const uint32_t p_i = m_position[i];
+			const uint32_t p_j = m_position[A.block_column(b)];
+			if (p_i < p_j && !A.upper_only()) {
+				continue;
+			}
+			const uint32_t row = std::max(p_i, p_j);
+			const uint32_t column = std::min(p_i, p_j);
+			const uint32_t s = m_node_super[column];
+			const uint32_t* rows_begin = m_rows.data() + m_row_offsets[s];
+			const uint32_t* rows_end = m_rows.data() + m_row_offsets[s + 1];
+			const uint32_t r = (uint32_t)(std::lower_bound(rows_begin, rows_end, row) - rows_begin);
+			assert(rows_begin + r < rows_end && rows_begin[r] == row);
+			const size_t ld = 3 * (size_t)(rows_end - rows_begin);
+			m_block_targets[b] = m_value_offsets[s] + 3 * (size_t)(column - m_super_begin[s]) * ld + 3 * (size_t)r;
+			m_block_transposed[b] = p_i < p_j;
+		}
+	}
+
+	m_pattern = A.pattern_handle();
+}
+
+} // namespace sim
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <utility>
+#include <limits>
+
+#include "sim/IFEM.hpp"
+#include "sim/BlockSparseMatrix.hpp"
+
+namespace sim {
+
+// Supernodal sparse Cholesky factorization P * A * P^T = L * L^T of a symmetric positive definite
+// block sparse matrix, for direct solves. The nodes are ordered by approximate minimum degree,
+// and consecutive nodes of the elimination tree with the same structure in L are grouped in
+// supernodes, whose columns are stored as dense panels and factorized with dense products.
+// The ordering and the symbolic factorization are only computed when the pattern of the matrix
+// changes, the following matrices with the same pattern are only refactorized.
+// The independent subtrees of the elimination tree are factorized in parallel, and the
+// supernodes above them in order, so the result does not depend on the number of threads.
+class SparseCholesky {
+public:
+
+	SparseCholesky() = default;
+
+	// Factorizes A, which must be symmetric. Returns false if A is not positive definite
+	bool compute(const BlockSparseMatrix& A);
+
+	// x = A^-1 * b
+	void solve(const Vec& b, Vec* x) const;
+
+private:
+
+	typedef Eigen::Matrix<Float, Eigen::Dynamic, Eigen::Dynamic> DenseMat;
+	typedef Eigen::Map<DenseMat> PanelRef;
+	typedef Eigen::Map<const DenseMat> ConstPanelRef;
+
+	// Pattern of the last analyzed matrix
+	BlockSparseMatrix::PatternHandle m_pattern;
+
+	// m_order[k] is the node of A in the position k of L, and m_position is its inverse
+	std::vector<uint32_t> m_order;
+	std::vector<uint32_t> m_position;
+
+	// The supernode s has the nodes [m_super_begin[s], m_super_begin[s + 1]) of L
+	std::vector<uint32_t> m_super_begin;
+	std::vector<uint32_t> m_node_super;
+
+	// Rows of the panel of each supernode, its own nodes followed by the nodes below them in
+	// increasing order, in the range [m_row_offsets[s], m_row_offsets[s + 1]) of m_rows
+	std::vector<uint32_t> m_row_offsets;
+	std::vector<uint32_t> m_rows;
+
+	// Column major panel of each supernode, from m_value_offsets[s]. The diagonal block holds
+	// the lower triangle of L, and the rows below it the rest of the columns of the supernode
+	std::vector<size_t> m_value_offsets;
+	std::vector<Float> m_values;
+
+	// Position in m_values of each block of A, with its transpose if the block is stored above
+	// the diagonal of L. Blocks of full storage above the diagonal of L are NO_TARGET
+	std::vector<size_t> m_block_targets;
+	std::vector<bool> m_block_transposed;
+	static constexpr size_t NO_TARGET = std::numeric_limits<size_t>::max();
+	static constexpr uint32_t NO_SUPERNODE = std::numeric_limits<uint32_t>::max();
+
+	// Supernodes of up to RELAXED_COLUMNS nodes always merge, and larger ones while the fraction
+	// of zeros they store is under RELAXED_ZEROS
+	static constexpr size_t RELAXED_COLUMNS = 4;
+	static constexpr double RELAXED_ZEROS = 0.1;
+
+	// Ranges of supernodes [first, second) of the subtrees factorized in parallel, and the
+	// supernodes above them, factorized afterwards. The subtrees are the largest ones with less
+	// than 1 / SUBTREE_TASKS of the work, so they do not depend on the number of threads
+	std::vector<std::pair<uint32_t, uint32_t>> m_subtrees;
+	std::vector<uint32_t> m_top_supernodes;
+	static constexpr double SUBTREE_TASKS = 64.0;
+	// Rows of the panels of m_top_supernodes updated and solved by a thread at a time
+	static constexpr uint32_t SLAB_NODES = 32;
+
+	// Updates waiting for each supernode, see compute
+	std::vector<uint32_t> m_update_heads;
+	std::vector<uint32_t> m_update_next;
+	std::vector<uint32_t> m_update_rows;
+	// Supernodes that update the current top supernode, and their update_columns_end
+	std::vector<uint32_t> m_top_updates;
+	std::vector<uint32_t> m_top_update_ends;
+
+	// Work space of each thread in the factorization
+	struct Workspace {
+		// Row of each node in the panel of the supernode being factorized
+		std::vector<uint32_t> relative_rows;
+		DenseMat update;
+	};
+	std::vector<Workspace> m_workspaces;
+
+	// Work space of the solves
+	mutable Vec m_y;
+	mutable Vec m_below;
+
+	uint32_t num_supernodes() const { return (uint32_t)m_super_begin.size() - 1; }
+
+	// Panel of the supernode s, with its number of rows
+	PanelRef panel(uint32_t s);
+	ConstPanelRef panel(uint32_t s) const;
+
+	// Computes the ordering, the supernodes and the structure of the panels
+	void analyze(const BlockSparseMatrix& A);
+
+	// Splits the elimination tree of the supernodes in m_subtrees and m_top_supernodes
+	void build_subtrees();
+
+	// Fill reducing order of the nodes, followed by a postorder of the elimination tree, so the
+	// nodes of each subtree are consecutive. Returns the parent of each position, or NO_SUPERNODE
+	std::vector<uint32_t> order_nodes(const std::vector<std::vector<uint32_t>>& adjacency);
+
+	// Receives the updates waiting for the supernode s and factorizes it. The updates that s and
+	// the supernodes it receives send to supernodes from link_end on are not linked yet.
+	// Returns false if the matrix is not positive definite
+	bool factorize_supernode(uint32_t s, uint32_t link_end, Workspace* workspace);
+
+	// Factorizes m_top_supernodes in order, each one with all the threads
+	bool factorize_top_supernodes();
+
+	// Sets the relative rows of the workspace to the rows of the panel of s
+	void set_relative_rows(uint32_t s, Workspace* workspace) const;
+
+	// First row of the supernode d below the columns of s, the supernode of m_rows[m_update_rows[d]]
+	uint32_t update_columns_end(uint32_t d, uint32_t s) const;
+
+	// Subtracts the products of the columns of the supernode d to the rows of the panel of s
+	// given by the rows [begin, end) of d, where last is update_columns_end(d, s)
+	void update_supernode(uint32_t d, uint32_t s, uint32_t last, uint32_t begin, uint32_t end,
+		Workspace* workspace);
+
+	// Links d to the supernode of its next update, if it has one and it is before link_end
+	void link_update(uint32_t d, uint32_t link_end);
+
+}; // class SparseCholesky
+
+} // namespace sim
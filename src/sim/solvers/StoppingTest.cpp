@@ -0,0 +1,46 @@
+#include "StoppingTest.hpp"
+
+#include <algorithm>
+
+namespace sim {
+
+void StoppingTest::begin(Eigen::Index size, Float rhs_norm, Float initial_residual_norm)
+{
+	m_max_iterations = m_policy.max_iterations > 0 ? m_policy.max_iterations : (uint32_t)size;
+
+	switch (m_policy.criterion) {
+	case StoppingCriterion::Absolute:
+		m_tolerance = m_policy.absolute_tolerance;
+		break;
+	case StoppingCriterion::RelativeToRhs:
+		m_tolerance = m_policy.relative_tolerance * rhs_norm;
+		break;
+	case StoppingCriterion::RelativeToInitialResidual:
+		m_tolerance = m_policy.relative_tolerance * initial_residual_norm;
+		break;
+	case StoppingCriterion::Adaptive:
+	{
+		const Float eta = this->forcing_term(rhs_norm);
+		m_tolerance = eta * rhs_norm;
+		m_previous_rhs_norm = rhs_norm;
+		break;
+	}
+	}
+}
+
+Float StoppingTest::forcing_term(Float rhs_norm) const
+{
+	// Second choice of Eisenstat and Walker, eta = gamma * (|b| / |b_prev|)^2. The upper bound is
+	// lower than their 0.9, as the solution of a step is not refined by more Newton iterations,
+	// and under it their safeguard against a quickly falling eta is never active
+	const Float gamma = Float(0.9);
+	const Float max_eta = Float(0.1);
+
+	if (m_previous_rhs_norm == Float(0)) {
+		return max_eta;
+	}
+	const Float ratio = rhs_norm / m_previous_rhs_norm;
+	return std::max(m_policy.relative_tolerance, std::min(max_eta, gamma * ratio * ratio));
+}
+
+} // namespace sim
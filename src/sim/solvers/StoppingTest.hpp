@@ -0,0 +1,45 @@
+#pragma once
+
+#include "sim/IFEM.hpp"
+
+namespace sim {
+
+// Tolerance and iteration limit of each solve of the conjugate gradient solvers from a stopping
+// policy, with the forcing term of the adaptive criterion carried between solves
+class StoppingTest {
+public:
+
+	StoppingTest() = default;
+
+	void set_policy(const StoppingPolicy& policy) { m_policy = policy; }
+
+	// Forgets the previous solves, when the unknowns of the system change
+	void clear() { m_previous_rhs_norm = Float(0); }
+
+	// Sets the tolerance and the iteration limit of a solve with size unknowns,
+	// from the norms of the right hand side and of the residual of the initial guess
+	void begin(Eigen::Index size, Float rhs_norm, Float initial_residual_norm);
+
+	// Tolerance of the norm of the residual in the current solve
+	Float tolerance() const { return m_tolerance; }
+
+	// The solvers compare squared norms
+	Float squared_tolerance() const { return m_tolerance * m_tolerance; }
+
+	uint32_t max_iterations() const { return m_max_iterations; }
+
+private:
+
+	StoppingPolicy m_policy;
+	Float m_tolerance = Float(0);
+	uint32_t m_max_iterations = 0;
+
+	// |b| of the last adaptive solve, zero before the first one
+	Float m_previous_rhs_norm = Float(0);
+
+	// Forcing term eta of the adaptive criterion for a solve with |b| = rhs_norm
+	Float forcing_term(Float rhs_norm) const;
+
+}; // class StoppingTest
+
+} // namespace sim
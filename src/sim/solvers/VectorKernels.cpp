@@ -0,0 +1,234 @@
+#include "VectorKernels.hpp"
+
+#include <omp.h>
+#include <algorithm>
+#include <cassert>
+
+namespace sim {
+
+namespace {
+
+// Static range of nodes of the calling thread inside a parallel region
+inline void thread_range(uint32_t num_nodes, uint32_t* begin, uint32_t* end)
+{
+	const uint32_t threads = (uint32_t)omp_get_num_threads();
+	const uint32_t chunk = (num_nodes + threads - 1) / threads;
+	*begin = std::min(num_nodes, (uint32_t)omp_get_thread_num() * chunk);
+	*end = std::min(num_nodes, *begin + chunk);
+}
+
+} // namespace
+
+template<typename Kernel>
+void VectorKernels::reduce(uint32_t num_nodes, uint32_t num_sums, const Kernel& kernel, Float* out)
+{
+	m_partial_sums.resize((size_t)omp_get_max_threads() * num_sums);
+	int32_t num_threads = 1;
+#pragma omp parallel
+	{
+		uint32_t begin;
+		uint32_t end;
+		thread_range(num_nodes, &begin, &end);
+		kernel(begin, end, m_partial_sums.data() + (size_t)omp_get_thread_num() * num_sums);
+
+#pragma omp single nowait
+		num_threads = omp_get_num_threads();
+	}
+
+	for (uint32_t s = 0; s < num_sums; ++s) {
+		out[s] = Float(0);
+		for (int32_t t = 0; t < num_threads; ++t) {
+			out[s] += m_partial_sums[(size_t)t * num_sums + s];
+		}
+	}
+}
+
+Float VectorKernels::dot(const Vec& a, const Vec& b)
+{
+	assert(a.rows() == b.rows() && a.rows() % 3 == 0);
+	Float result;
+	this->reduce((uint32_t)(a.rows() / 3), 1, [&](uint32_t begin, uint32_t end, Float* sums) {
+		const Eigen::Index offset = 3 * (Eigen::Index)begin;
+		const Eigen::Index size = 3 * (Eigen::Index)(end - begin);
+		sums[0] = a.segment(offset, size).dot(b.segment(offset, size));
+	}, &result);
+	return result;
+}
+
+Float VectorKernels::multiply_dot(const SMat& A, const Vec& x, Vec* y)
+{
+	assert(A.rows() == A.cols() && A.rows() == x.rows());
+	assert(A.isCompressed());
+	assert(y != nullptr);
+	y->resize(x.rows());
+	const SMat::StorageIndex* offsets = A.outerIndexPtr();
+	const SMat::StorageIndex* rows = A.innerIndexPtr();
+	const Float* values = A.valuePtr();
+	const Float* x_data = x.data();
+	Float* y_data = y->data();
+	Float result;
+	this->reduce((uint32_t)(x.rows() / 3), 1, [&](uint32_t begin, uint32_t end, Float* sums) {
+		Float sum = Float(0);
+		for (Eigen::Index j = 3 * (Eigen::Index)begin; j < 3 * (Eigen::Index)end; ++j) {
+			// Two partial sums, so the additions do not wait for each other
+			Float y_j[2] = { Float(0), Float(0) };
+			SMat::StorageIndex k = offsets[j];
+			for (; k + 1 < offsets[j + 1]; k += 2) {
+				y_j[0] += values[k] * x_data[rows[k]];
+				y_j[1] += values[k + 1] * x_data[rows[k + 1]];
+			}
+			if (k < offsets[j + 1]) {
+				y_j[0] += values[k] * x_data[rows[k]];
+			}
+			y_data[j] = y_j[0] + y_j[1];
+			sum += x_data[j] * y_data[j];
+		}
+		sums[0] = sum;
+	}, &result);
+	return result;
+}
+
+Float VectorKernels::multiply_dot(const BlockSparseMatrix& A, const Vec& x, Vec* y)
+{
+	assert(A.cols() == x.rows());
+	assert(y != nullptr);
+	y->resize(A.rows());
+	Float result;
+	this->reduce(A.block_rows(), 1, [&](uint32_t begin, uint32_t end, Float* sums) {
+		sums[0] = A.multiply_rows(x, begin, end, y);
+	}, &result);
+	return result;
+}
+
+Float VectorKernels::update(Float alpha, const Vec& p, const Vec& Ap, Vec* x, Vec* r)
+{
+	assert(x != nullptr && r != nullptr);
+	Float result;
+	this->reduce((uint32_t)(p.rows() / 3), 1, [&](uint32_t begin, uint32_t end, Float* sums) {
+		sums[0] = Float(0);
+		for (uint32_t tile = begin; tile < end; tile += TILE_NODES) {
+			const Eigen::Index k = 3 * (Eigen::Index)tile;
+			const Eigen::Index n = 3 * (Eigen::Index)(std::min(end, tile + TILE_NODES) - tile);
+			x->segment(k, n) += alpha * p.segment(k, n);
+			r->segment(k, n) -= alpha * Ap.segment(k, n);
+			sums[0] += r->segment(k, n).squaredNorm();
+		}
+	}, &result);
+	return result;
+}
+
+void VectorKernels::update(Float alpha, const Vec& p, const Vec& Ap, const Vec& inv_diagonal,
+	Vec* x, Vec* r, Vec* z, Float* rr, Float* rz)
+{
+	assert(x != nullptr && r != nullptr && z != nullptr);
+	Float result[2];
+	this->reduce((uint32_t)(p.rows() / 3), 2, [&](uint32_t begin, uint32_t end, Float* sums) {
+		sums[0] = Float(0);
+		sums[1] = Float(0);
+		for (uint32_t tile = begin; tile < end; tile += TILE_NODES) {
+			const Eigen::Index k = 3 * (Eigen::Index)tile;
+			const Eigen::Index n = 3 * (Eigen::Index)(std::min(end, tile + TILE_NODES) - tile);
+			x->segment(k, n) += alpha * p.segment(k, n);
+			r->segment(k, n) -= alpha * Ap.segment(k, n);
+			z->segment(k, n) = inv_diagonal.segment(k, n).cwiseProduct(r->segment(k, n));
+			sums[0] += r->segment(k, n).squaredNorm();
+			sums[1] += r->segment(k, n).dot(z->segment(k, n));
+		}
+	}, result);
+	*rr = result[0];
+	*rz = result[1];
+}
+
+void VectorKernels::update(Float alpha, const Vec& p, const Vec& Ap, const std::vector<Mat3>& inv_blocks,
+	Vec* x, Vec* r, Vec* z, Float* rr, Float* rz)
+{
+	assert(x != nullptr && r != nullptr && z != nullptr);
+	assert(inv_blocks.size() == (size_t)p.rows() / 3);
+	Float result[2];
+	this->reduce((uint32_t)inv_blocks.size(), 2, [&](uint32_t begin, uint32_t end, Float* sums) {
+		sums[0] = Float(0);
+		sums[1] = Float(0);
+		for (uint32_t tile = begin; tile < end; tile += TILE_NODES) {
+			const uint32_t tile_end = std::min(end, tile + TILE_NODES);
+			const Eigen::Index k = 3 * (Eigen::Index)tile;
+			const Eigen::Index n = 3 * (Eigen::Index)(tile_end - tile);
+			x->segment(k, n) += alpha * p.segment(k, n);
+			r->segment(k, n) -= alpha * Ap.segment(k, n);
+			for (uint32_t i = tile; i < tile_end; ++i) {
+				z->segment<3>(3 * (Eigen::Index)i).noalias() = inv_blocks[i] * r->segment<3>(3 * (Eigen::Index)i);
+			}
+			sums[0] += r->segment(k, n).squaredNorm();
+			sums[1] += r->segment(k, n).dot(z->segment(k, n));
+		}
+	}, result);
+	*rr = result[0];
+	*rz = result[1];
+}
+
+void VectorKernels::update_direction(Float beta, const Vec& z, Vec* p)
+{
+	assert(p != nullptr && p->rows() == z.rows());
+#pragma omp parallel
+	{
+		uint32_t begin;
+		uint32_t end;
+		thread_range((uint32_t)(z.rows() / 3), &begin, &end);
+		const Eigen::Index k = 3 * (Eigen::Index)begin;
+		const Eigen::Index n = 3 * (Eigen::Index)(end - begin);
+		p->segment(k, n) = z.segment(k, n) + beta * p->segment(k, n);
+	}
+}
+
+template<typename Precondition>
+void VectorKernels::pipelined_update_impl(Float alpha, Float beta, const Precondition& precondition,
+	Vec* x, Pipeline* v, Float sums[3])
+{
+	assert(x != nullptr && v != nullptr);
+	this->reduce((uint32_t)(x->rows() / 3), 3, [&](uint32_t begin, uint32_t end, Float* partial) {
+		partial[0] = Float(0);
+		partial[1] = Float(0);
+		partial[2] = Float(0);
+		for (uint32_t tile = begin; tile < end; tile += TILE_NODES) {
+			const Eigen::Index k = 3 * (Eigen::Index)tile;
+			const Eigen::Index n = 3 * (Eigen::Index)(std::min(end, tile + TILE_NODES) - tile);
+			v->z.segment(k, n) = v->n.segment(k, n) + beta * v->z.segment(k, n);
+			v->q.segment(k, n) = v->m.segment(k, n) + beta * v->q.segment(k, n);
+			v->s.segment(k, n) = v->w.segment(k, n) + beta * v->s.segment(k, n);
+			v->p.segment(k, n) = v->u.segment(k, n) + beta * v->p.segment(k, n);
+			x->segment(k, n) += alpha * v->p.segment(k, n);
+			v->r.segment(k, n) -= alpha * v->s.segment(k, n);
+			v->u.segment(k, n) -= alpha * v->q.segment(k, n);
+			v->w.segment(k, n) -= alpha * v->z.segment(k, n);
+			partial[0] += v->r.segment(k, n).dot(v->u.segment(k, n));
+			partial[1] += v->w.segment(k, n).dot(v->u.segment(k, n));
+			partial[2] += v->r.segment(k, n).squaredNorm();
+			precondition(k, n);
+		}
+	}, sums);
+}
+
+void VectorKernels::pipelined_update(Float alpha, Float beta, Vec* x, Pipeline* v, Float sums[3])
+{
+	this->pipelined_update_impl(alpha, beta, [](Eigen::Index, Eigen::Index) {}, x, v, sums);
+}
+
+void VectorKernels::pipelined_update(Float alpha, Float beta, const Vec& inv_diagonal,
+	Vec* x, Pipeline* v, Float sums[3])
+{
+	this->pipelined_update_impl(alpha, beta, [&](Eigen::Index k, Eigen::Index n) {
+		v->m.segment(k, n) = inv_diagonal.segment(k, n).cwiseProduct(v->w.segment(k, n));
+	}, x, v, sums);
+}
+
+void VectorKernels::pipelined_update(Float alpha, Float beta, const std::vector<Mat3>& inv_blocks,
+	Vec* x, Pipeline* v, Float sums[3])
+{
+	assert(inv_blocks.size() == (size_t)x->rows() / 3);
+	this->pipelined_update_impl(alpha, beta, [&](Eigen::Index k, Eigen::Index n) {
+		for (Eigen::Index i = k / 3; i < (k + n) / 3; ++i) {
+			v->m.segment<3>(3 * i).noalias() = inv_blocks[i] * v->w.segment<3>(3 * i);
+		}
+	}, x, v, sums);
+}
+
+} // namespace sim
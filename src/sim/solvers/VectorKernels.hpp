@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <vector>
+
+#include "sim/IFEM.hpp"
+#include "sim/BlockSparseMatrix.hpp"
+
+namespace sim {
+
+// Fused vector operations of the conjugate gradient, parallel with OpenMP, so an iteration
+// reads each vector as few times as possible. The vectors are split by nodes in a static range
+// per thread, and the partial sums of the threads are added in order, so the results only
+// depend on the number of threads.
+class VectorKernels {
+public:
+
+	VectorKernels() = default;
+
+	// a^T * b
+	Float dot(const Vec& a, const Vec& b);
+
+	// y = A * x, and returns x^T * y. A must be symmetric, as its columns are read as rows
+	Float multiply_dot(const SMat& A, const Vec& x, Vec* y);
+
+	// y = A * x, and returns x^T * y
+	Float multiply_dot(const BlockSparseMatrix& A, const Vec& x, Vec* y);
+
+	// x += alpha * p and r -= alpha * Ap, and returns r^T * r
+	Float update(Float alpha, const Vec& p, const Vec& Ap, Vec* x, Vec* r);
+
+	// x += alpha * p, r -= alpha * Ap and z = D^-1 * r, where inv_diagonal is D^-1.
+	// Returns r^T * r in rr, and r^T * z in rz
+	void update(Float alpha, const Vec& p, const Vec& Ap, const Vec& inv_diagonal,
+		Vec* x, Vec* r, Vec* z, Float* rr, Float* rz);
+
+	// Same with the inverse 3x3 diagonal blocks of each node
+	void update(Float alpha, const Vec& p, const Vec& Ap, const std::vector<Mat3>& inv_blocks,
+		Vec* x, Vec* r, Vec* z, Float* rr, Float* rz);
+
+	// p = z + beta * p
+	void update_direction(Float beta, const Vec& z, Vec* p);
+
+	// Vectors of the pipelined conjugate gradient [Ghysels and Vanroose 2014],
+	// where u = M^-1 * r, w = A * u, m = M^-1 * w and n = A * m
+	struct Pipeline {
+		Vec r;
+		Vec u;
+		Vec w;
+		Vec m;
+		Vec n;
+		Vec z;
+		Vec q;
+		Vec s;
+		Vec p;
+	};
+
+	// Updates of an iteration of the pipelined conjugate gradient, in one pass:
+	// z = n + beta * z, q = m + beta * q, s = w + beta * s, p = u + beta * p,
+	// x += alpha * p, r -= alpha * s, u -= alpha * q and w -= alpha * z.
+	// Returns r^T * u, w^T * u and r^T * r of the new vectors in sums
+	void pipelined_update(Float alpha, Float beta, Vec* x, Pipeline* v, Float sums[3]);
+
+	// Same, and also m = D^-1 * w for the next iteration
+	void pipelined_update(Float alpha, Float beta, const Vec& inv_diagonal, Vec* x, Pipeline* v, Float sums[3]);
+
+	// Same with the inverse 3x3 diagonal blocks of each node
+	void pipelined_update(Float alpha, Float beta, const std::vector<Mat3>& inv_blocks,
+		Vec* x, Pipeline* v, Float sums[3]);
+
+private:
+
+	// Nodes updated at a time by the fused kernels, so that the vectors of a tile are
+	// still in the L1 cache for the reductions
+	static constexpr uint32_t TILE_NODES = 128;
+
+	// Sums of each thread in the last reduction
+	std::vector<Float> m_partial_sums;
+
+	// Calls kernel(begin, end, sums) with the range of nodes of each thread, where each thread
+	// writes its num_sums partial sums, and adds them in out
+	template<typename Kernel>
+	void reduce(uint32_t num_nodes, uint32_t num_sums, const Kernel& kernel, Float* out);
+
+	// pipelined_update with precondition(k, n), which applies the preconditioner to w
+	// in the range [k, k + n)
+	template<typename Precondition>
+	void pipelined_update_impl(Float alpha, Float beta, const Precondition& precondition,
+		Vec* x, Pipeline* v, Float sums[3]);
+
+}; // class VectorKernels
+
+} // namespace sim